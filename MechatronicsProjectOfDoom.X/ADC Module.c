@@ -0,0 +1,300 @@
+/*********************************************************************
+ * FileName:        ADC Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Timer driven ADC sampling, see ADC Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#if defined(__18CXX)
+#include <p18f4520.h>
+#include <adc.h>
+#else
+#include "adchost.h"    // Host (gcc) build against tools/oversim
+#endif
+#include "ADC Module.h"
+#include "Clock Module.h"
+#include "Trace Module.h"
+
+// ADCON0 CHS bits, only while GO is clear
+#define ADCChannel(an)  (ADCON0 = (ADCON0 & 0b11000011) | ((an) << 2))
+
+rom unsigned char _vADCchannel[ADC_CHANNELS] = {ADC_CHANNEL_LIST}; //ANx of each position
+
+int _vADCbuf[ADC_CHANNELS][2]; //double buffer, the interrupt fills the half that isn't published
+unsigned int _vADCstamp[ADC_CHANNELS][2]; //  and the ClockStamp() of each sample
+volatile unsigned char _vADCidx[ADC_CHANNELS]; //half holding the latest sample
+volatile unsigned char _vADCseq[ADC_CHANNELS]; //bumped after every published sample
+int _vADCring[ADC_RING]; //position 0's last ADC_RING samples, sequence number & (ADC_RING - 1)
+unsigned char _vADCpos = 0; //list position being sampled
+unsigned int _vADCstart; //ClockStamp() at the start of this sample
+unsigned char _vADCclock; //ADCON2 ADCS bits to go back to after ADCSlow(1)
+#if ADC_OVERSAMPLE_BITS
+unsigned int _vADCsum = 0; //conversions so far this burst, added up
+volatile unsigned char _vADCleft = ADC_BURST; //conversions to go, ADC_BURST between bursts
+#endif
+
+/*********************************************************************
+ * Function         :void ADCSampleInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Takes over the ADC, Timer3 and their interrupts
+ * Overview         :AN0 up to the highest channel in the list analog,
+ *                   right justified, 12 TAD (24 us) automatic
+ *                   acquisition so a conversion can start the moment
+ *                   Timer3 asks for it.  Position 0 first.
+ * Note             :Sampling starts once GIEH is set
+ ********************************************************************/
+void ADCSampleInit(void) {
+    unsigned char i, top = 0;
+
+    for (i = 0; i < ADC_CHANNELS; i++) {
+        _vADCidx[i] = 0;
+        _vADCseq[i] = 0;
+        if (_vADCchannel[i] > top)
+            top = _vADCchannel[i];
+    }
+    _vADCpos = 0;
+    OpenADC(ADC_CLOCK & ADC_RIGHT_JUST & ADC_12_TAD,
+            ADC_CH0 & ADC_INT_ON & ADC_REF_VDD_VSS,
+            14 - top); // PCFG, 0b1110 AN0 only, one less for each channel above
+    ADCChannel(_vADCchannel[0]);
+    IPR1bits.ADIP = 1; // high priority
+    PIR1bits.ADIF = 0;
+    PIE1bits.ADIE = 1;
+
+    TMR3H = ADC_TMR3_RELOAD >> 8;
+    TMR3L = ADC_TMR3_RELOAD & 0xFF;
+    T3CON = 0b10000001; // 16 bit writes, prescale 1:1, internal clock (Fosc/4), on
+    IPR2bits.TMR3IP = 1; // high priority
+    PIR2bits.TMR3IF = 0;
+    PIE2bits.TMR3IE = 1;
+}
+
+/*********************************************************************
+ * Function         :void ADCTimerISR(void)
+ * PreCondition     :PIR2bits.TMR3IF is set
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Clears PIR2bits.TMR3IF
+ * Overview         :Adds the reload to whatever Timer3 has counted since
+ *                   the overflow, so the time the interrupt took to get
+ *                   here doesn't stretch the period, and starts a
+ *                   conversion of the channel already selected.  The
+ *                   ADC inserts the acquisition time.
+ * Note             :Call from high_isr
+ ********************************************************************/
+void ADCTimerISR(void) {
+    unsigned int t;
+
+    t = TMR3L; // reading TMR3L latches TMR3H
+    t |= (unsigned int) TMR3H << 8;
+    t += ADC_TMR3_RELOAD;
+    TMR3H = t >> 8; // latched, written together with TMR3L
+    TMR3L = t & 0xFF;
+    PIR2bits.TMR3IF = 0;
+    ADCON0bits.GO = 1;
+    _vADCstart = ClockStamp();
+    TraceBeginHigh(TR_ADC);
+}
+
+/*********************************************************************
+ * Function         :void ADCSampleISR(void)
+ * PreCondition     :PIR1bits.ADIF is set
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Clears PIR1bits.ADIF
+ * Overview         :Oversampling, adds the result up and starts the
+ *                   next conversion until the burst is done.  Then
+ *                   stores the sample and its stamp in the unpublished
+ *                   half of the channel's buffer, swaps halves and bumps
+ *                   the sequence number, in that order, so ADCRead()
+ *                   never sees a half written value.  Position 0 also
+ *                   goes into the ring for ADCNext().  Then it switches the
+ *                   multiplexer to the next channel.  In ADCSlow(1) that
+ *                   channel is started straight away, to the end of the
+ *                   list.
+ * Note             :Call from high_isr
+ ********************************************************************/
+void ADCSampleISR(void) {
+    unsigned char pos = _vADCpos;
+    unsigned char next = _vADCidx[pos] ^ 1;
+
+    PIR1bits.ADIF = 0;
+#if ADC_OVERSAMPLE_BITS
+    _vADCsum += ((unsigned int) ADRESH << 8) | ADRESL;
+    if (--_vADCleft) {
+        ADCON0bits.GO = 1; // the ADC puts the acquisition time in first
+        return;
+    }
+    // 4^N results added up is 10 + 2N bits, keep the top 10 + N, rounded
+    _vADCbuf[pos][next] = (_vADCsum + (1 << (ADC_OVERSAMPLE_BITS - 1))) >> ADC_OVERSAMPLE_BITS;
+    _vADCsum = 0;
+    _vADCleft = ADC_BURST;
+#else
+    _vADCbuf[pos][next] = ((int) ADRESH << 8) | ADRESL;
+#endif
+    _vADCstamp[pos][next] = _vADCstart;
+    if (!pos)
+        _vADCring[(unsigned char) (_vADCseq[0] + 1) & (ADC_RING - 1)] = _vADCbuf[0][next];
+    TraceEndHigh(TR_ADC);
+    _vADCidx[pos] = next;
+    _vADCseq[pos]++;
+#if ADC_CHANNELS > 1
+    if (++pos == ADC_CHANNELS)
+        pos = 0;
+    _vADCpos = pos;
+    ADCChannel(_vADCchannel[pos]); // settles until the next GO
+    if (pos && !T3CONbits.TMR3ON) {
+        TraceBeginHigh(TR_ADC);
+        ADCON0bits.GO = 1; // ADCStart() scan, the ADC puts the acquisition time in first
+        _vADCstart = ClockStamp();
+    }
+#endif
+}
+
+/*********************************************************************
+ * Function         :void ADCSlow(char on)
+ * PreCondition     :ADCSampleInit() has been called
+ * Input            :on - 1 for the RC clock, 0 for Timer3 sampling
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :The RC clock (TAD 1 - 6 us) is the only one that
+ *                   keeps going in Sleep.  Timer3 restarts a full
+ *                   ADC_SLOT_US from now.  A sample that is being
+ *                   converted is let finish first, ADC_BURST x 46 us
+ *                   at most, then the scan goes back to position 0.
+ * Note             :Main loop only
+ ********************************************************************/
+void ADCSlow(char on) {
+    T3CONbits.TMR3ON = 0;
+    PIR2bits.TMR3IF = 0;
+    while (ADCBusy());
+    _vADCpos = 0;
+    ADCChannel(_vADCchannel[0]);
+    if (on) {
+        _vADCclock = ADCON2 & 0x07;
+        ADCON2 |= 0x07; // ADCS = FRC
+        return;
+    }
+    ADCON2 = (ADCON2 & 0xF8) | _vADCclock;
+    TMR3H = ADC_TMR3_RELOAD >> 8;
+    TMR3L = ADC_TMR3_RELOAD & 0xFF;
+    T3CONbits.TMR3ON = 1;
+}
+
+/*********************************************************************
+ * Function         :void ADCStart(void)
+ * PreCondition     :ADCSlow(1)
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :On the RC clock the conversion waits one
+ *                   instruction before it starts, long enough for a
+ *                   Sleep() straight after this to go in first.  The
+ *                   rest of an oversampling burst, and the rest of the
+ *                   channels, follow on from the interrupt, asleep or
+ *                   not.
+ * Note             :None
+ ********************************************************************/
+void ADCStart(void) {
+    TraceBegin(TR_ADC);
+    _vADCstart = ClockStamp();
+    ADCON0bits.GO = 1;
+}
+
+/*********************************************************************
+ * Function         :char ADCBusy(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :1 from the start of a sample to its publication
+ * Side Effects     :None
+ * Overview         :GO covers a single conversion, the burst count the
+ *                   gaps between them while the interrupt is pending
+ * Note             :None
+ ********************************************************************/
+char ADCBusy(void) {
+#if ADC_OVERSAMPLE_BITS
+    if (_vADCleft != ADC_BURST)
+        return 1;
+#endif
+    return ADCON0bits.GO;
+}
+
+/*********************************************************************
+ * Function         :unsigned char ADCRead(unsigned char pos, int *value,
+ *                                         unsigned int *stamp)
+ * PreCondition     :ADCSampleInit() has been called
+ * Input            :pos - position in ADC_CHANNEL_LIST
+ *                   value - where to put its newest sample
+ *                   stamp - where to put the ClockStamp() it was taken at
+ * Output           :Sequence number of that sample
+ * Side Effects     :None
+ * Overview         :Lock free, interrupts stay on.  If a new sample is
+ *                   published while the four bytes are being copied the
+ *                   sequence number will have moved and the copy is
+ *                   simply done again.
+ * Note             :None
+ ********************************************************************/
+unsigned char ADCRead(unsigned char pos, int *value, unsigned int *stamp) {
+    unsigned char seq, idx;
+
+    do {
+        seq = _vADCseq[pos];
+        idx = _vADCidx[pos];
+        *value = _vADCbuf[pos][idx];
+        *stamp = _vADCstamp[pos][idx];
+    } while (seq != _vADCseq[pos]);
+    return seq;
+}
+
+/*********************************************************************
+ * Function         :unsigned char ADCLatest(int *value)
+ * PreCondition     :ADCSampleInit() has been called
+ * Input            :value - where to put the newest IR sample
+ * Output           :Sequence number of that sample
+ * Side Effects     :None
+ * Overview         :ADCRead() of position 0
+ * Note             :None
+ ********************************************************************/
+unsigned char ADCLatest(int *value) {
+    unsigned int stamp;
+
+    return ADCRead(0, value, &stamp);
+}
+
+/*********************************************************************
+ * Function         :char ADCNext(unsigned char *seq, int *value)
+ * PreCondition     :ADCSampleInit() has been called
+ * Input            :seq - sequence number of the last IR sample taken
+ *                   value - where to put the one after it
+ * Output           :1 with *seq moved on to it, 0 if there isn't one yet
+ * Side Effects     :None
+ * Overview         :Takes the samples out of the ring in order, so a
+ *                   caller that comes round late still gets every one.
+ *                   If it is more than ADC_RING behind it skips to the
+ *                   oldest one left.  A slot the interrupt writes again
+ *                   while it is being copied moves the sequence number
+ *                   a whole ring on, and the copy is done again.
+ * Note             :One caller, it keeps its own *seq
+ ********************************************************************/
+char ADCNext(unsigned char *seq, int *value) {
+    unsigned char head, next;
+
+    do {
+        head = _vADCseq[0];
+        if (head == *seq)
+            return 0;
+        if ((unsigned char) (head - *seq) > ADC_RING)
+            next = head - ADC_RING + 1;
+        else
+            next = *seq + 1;
+        *value = _vADCring[next & (ADC_RING - 1)];
+    } while ((unsigned char) (_vADCseq[0] - next) >= ADC_RING);
+    *seq = next;
+    return 1;
+}
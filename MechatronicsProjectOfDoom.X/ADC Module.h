@@ -0,0 +1,171 @@
+/*********************************************************************
+ * FileName:        ADC Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Timer driven ADC sampling.  Timer3 overflows every ADC_SLOT_US and
+ * its interrupt starts a conversion, the ADC interrupt drops the result
+ * into one half of a double buffer and publishes it.  The main loop
+ * never waits on the converter, it just picks up the latest sample.
+ *
+ * Scanning: ADC_CHANNEL_LIST names the ADC_CHANNELS inputs to sample,
+ * one per Timer3 overflow, round and round, so every channel gets one
+ * slot of ADC_SAMPLE_US / ADC_CHANNELS and is sampled every
+ * ADC_SAMPLE_US on average, however many there are, +- the reload
+ * latency: ADCTimerISR() adds the reload to what Timer3 has counted,
+ * so a late start doesn't add up, but each one is as late as high_isr
+ * got there (tools/adcscan).  Position 0 is the IR sensor.
+ * The multiplexer moves on to the next channel as soon as a sample is
+ * published, so the holding capacitor has the rest of the slot to
+ * settle, and every conversion still gets the ADC's automatic 12 TAD
+ * (ADC_ACQ_NS) acquisition after GO, well over the ADC_TACQ_NS the
+ * datasheet asks for.  Each channel has its own latest value, sequence
+ * number and ClockStamp() of the Timer3 overflow that sampled it, see
+ * ADCRead().  Position 0 also keeps its last ADC_RING samples, so a
+ * task that comes round late still gets every one of them (ADCNext()).
+ * AN0 - AN7 only (RA0 - RA3, RA5, RE0 - RE2), AN8 and up are
+ * on PORTB with the buttons and keycard.  PCFG can only make AN0 up to
+ * the highest channel in the list analog, every pin in that range reads
+ * back 0 as a digital input (RA1, the detect output, still drives).  To
+ * add the pot on AN2:
+ *   #define ADC_CHANNELS 2
+ *   #define ADC_CHANNEL_LIST 0, 2
+ * Every slot has to hold a whole burst and leave half the CPU, the
+ * #errors below stop a list that doesn't.  At 4 MHz without
+ * oversampling 1 kHz is fine up to 4 channels; 8 need ADC_SAMPLE_US
+ * 2000, and the pot with ADC_OVERSAMPLE_BITS 1 needs 1200.
+ * tools/adcscan checks the timing and prints the shortest scan for 1,
+ * 4 and 8 channels at the clock and oversampling it is built with;
+ * tools/adcscan/examples.sh builds every example here.
+ *
+ * (CCP2's special event trigger could start the conversions in hardware,
+ * but CCP2 is kept free for PWM on RC1.)
+ *
+ * Both interrupts are high priority, in high_isr (see Interrupt Module.h,
+ * which also times Timer3's latency there):
+ *   if (PIR2bits.TMR3IF && PIE2bits.TMR3IE) ADCTimerISR();
+ *   if (PIR1bits.ADIF && PIE1bits.ADIE) ADCSampleISR();
+ * ADCTimerISR() adds the reload to what Timer3 has already counted, so
+ * a late interrupt delays one sample but doesn't shift the ones after.
+ *
+ * Oversampling is off by default, it's there for tuning.  With
+ * ADC_OVERSAMPLE_BITS = N each Timer3 overflow starts a burst of 4^N
+ * conversions, back to back, each ADC interrupt adding its result up
+ * and starting the next.  The sum, rounded and shifted right N, is
+ * published as one 10 + N bit sample.  That only buys real resolution
+ * if the reading has a bit of noise on it (half an LSB or more), which
+ * the IR sensor has plenty of, and it isn't cheap: N = 1 is about 36%
+ * of the CPU at 4 MHz and 1 kHz for under a bit of gain, and leaves no
+ * room to scan a second channel.  Every ADC value in the project is in
+ * ADC_BITS units, ADCScale() turns a 10 bit count into one.
+ * tools/oversim checks the gain on synthetic noisy signals and
+ * estimates the CPU it costs.
+ *
+ * ADCSlow(1) stops Timer3 and puts the converter on its own RC clock,
+ * so conversions started by ADCStart() run, and wake the CPU, in Sleep
+ * (see PowerNap()).  ADCStart() scans the whole list, one channel
+ * straight after the other.  Results come out through ADCSampleISR()
+ * and ADCRead() the same as ever.  ADCSlow(0) goes back to Timer3.
+ * Either way the next scan starts from position 0.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __ADC_MODULE_H
+#define __ADC_MODULE_H
+#include "Clock Module.h"
+
+#ifndef ADC_SAMPLE_US
+#define ADC_SAMPLE_US       1000    // Sample period of every channel, 1 kHz
+#endif
+#ifndef ADC_CHANNELS
+#define ADC_CHANNELS        1       // 1 - 8, define both, see above for what fits
+#define ADC_CHANNEL_LIST    0       // ANx of each position, in scan order
+#endif
+#define ADC_SLOT_US         (ADC_SAMPLE_US / ADC_CHANNELS) // Timer3 period, one channel each
+#ifndef ADC_OVERSAMPLE_BITS
+#define ADC_OVERSAMPLE_BITS 0       // 0 - 3, 4^N conversions a sample for N more bits
+#endif
+#define ADC_RING            8       // IR samples kept for ADCNext(), a power of 2
+#define ADC_BITS            (10 + ADC_OVERSAMPLE_BITS)
+#define ADC_MAX             ((1 << ADC_BITS) - 1)
+#define ADC_BURST           (1 << (2 * ADC_OVERSAMPLE_BITS)) // conversions a sample
+#define ADCScale(count10)   ((count10) << ADC_OVERSAMPLE_BITS) // 10 bit count in ADC_BITS units
+
+// Effective rates, ADC_SAMPLE_HZ for each channel
+#define ADC_SAMPLE_HZ       (1000000UL / ADC_SAMPLE_US)
+#define ADC_CONVERT_HZ      (ADC_SAMPLE_HZ * ADC_BURST * ADC_CHANNELS)
+#define ADC_TMR3_FIXUP      6       // Timer3 counts lost around the reload in ADCTimerISR()
+#define ADC_TMR3_RELOAD     (65536 - ClockTcy(ADC_SLOT_US) + ADC_TMR3_FIXUP) // 1 count = 1 instruction
+
+#if ADC_CHANNELS < 1 || ADC_CHANNELS > 8
+#error "ADC_CHANNELS must be 1 - 8"
+#endif
+#if ADC_SAMPLE_US % ADC_CHANNELS
+#error "ADC_SAMPLE_US has to divide into ADC_CHANNELS whole slots"
+#endif
+#if ClockTcy(ADC_SLOT_US) > 65535
+#error "ADC_SAMPLE_US is too long for Timer3 at this clock"
+#endif
+
+// ADC clock, TAD = 2 us at every CLOCK_FOSC (the minimum is 0.7 us)
+#if CLOCK_FOSC <= 4000000UL
+#define ADC_CLOCK           ADC_FOSC_8
+#define ADC_CLOCK_DIV       8
+#elif CLOCK_FOSC <= 8000000UL
+#define ADC_CLOCK           ADC_FOSC_16
+#define ADC_CLOCK_DIV       16
+#elif CLOCK_FOSC <= 16000000UL
+#define ADC_CLOCK           ADC_FOSC_32
+#define ADC_CLOCK_DIV       32
+#else
+#define ADC_CLOCK           ADC_FOSC_64
+#define ADC_CLOCK_DIV       64
+#endif
+#define ADC_TAD_NS          (ADC_CLOCK_DIV * 1000UL / CLOCK_TCY_PER_US / 4)
+#if ADC_TAD_NS < 700 || ADC_TAD_NS > 25000
+#error "ADC TAD out of range (0.7 - 25 us) at this clock"
+#endif
+
+// Acquisition, automatic after every GO (ADC_12_TAD), against the datasheet minimum
+// for a 2.5k source at 85 C, channel switch included
+#define ADC_ACQ_NS          (12 * ADC_TAD_NS)
+#define ADC_TACQ_NS         2450
+#if ADC_ACQ_NS < ADC_TACQ_NS
+#error "ADC acquisition time is too short at this clock"
+#endif
+
+// A burst has to be over before the next Timer3 overflow, 12 TAD acquisition + 11 TAD
+// conversion each and the interrupt between them, and shouldn't take more than half the
+// CPU, at an estimated ADC_ISR_TCY for each conversion (see tools/oversim; the adc line
+// of the Interrupt Module dump is the handler's real time, without the entry and exit)
+#define ADC_ISR_TCY         70
+#define ADC_BURST_US        (ADC_BURST * (23 * ADC_TAD_NS / 1000 + ADC_ISR_TCY / CLOCK_TCY_PER_US))
+#if ADC_OVERSAMPLE_BITS > 3
+#error "ADC_OVERSAMPLE_BITS can't be more than 3, the sum would overflow 16 bits"
+#endif
+#if ADC_BURST_US >= ADC_SLOT_US
+#error "ADC_OVERSAMPLE_BITS conversions don't fit in a slot, raise ADC_SAMPLE_US"
+#endif
+#if ADC_BURST * ADC_ISR_TCY * 2 > ClockTcy(ADC_SLOT_US)
+#error "ADC_OVERSAMPLE_BITS would take more than half the CPU at this clock, raise ADC_SAMPLE_US"
+#endif
+
+void ADCSampleInit(void); // Sets up the channels, Timer3 and both interrupts, needs RCONbits.IPEN and GIEH
+void ADCTimerISR(void); // Timer3 overflow - start the next channel's conversion
+void ADCSampleISR(void); // Conversion done - publish the result
+void ADCSlow(char on); // 1: RC clock, conversions only from ADCStart(), 0: back to Timer3
+void ADCStart(void); // Starts one scan (a sample of every channel) now
+char ADCBusy(void); // 1 while a sample is being converted
+
+// Copies the newest sample of list position pos into *value, and the ClockStamp() it was
+// taken at into *stamp, and returns its sequence number, which goes up by one (wrapping) for
+// every sample of that channel.  Never blocks, compare with the last number to spot new data.
+unsigned char ADCRead(unsigned char pos, int *value, unsigned int *stamp);
+unsigned char ADCLatest(int *value); // ADCRead() of position 0, the IR sensor, without the stamp
+// Every IR sample in turn, from a ring of the last ADC_RING the interrupt keeps: the one after
+// sequence number *seq into *value, *seq moved on to it, 0 if there's none yet
+char ADCNext(unsigned char *seq, int *value);
+
+#endif
@@ -0,0 +1,68 @@
+/*********************************************************************
+ * FileName:        Clock Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Oscillator setup, see Clock Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include <p18f4520.h>
+#include <delays.h>
+#include "Clock Module.h"
+
+/*********************************************************************
+ * Function         :void ClockInit(void)
+ * PreCondition     :OSC = INTIO67 in the config bits
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Everything runs at CLOCK_FOSC from here on, Timer1
+ *                   is taken for ClockStamp()
+ * Overview         :Picks the INTOSC frequency, turns the PLL on for
+ *                   16 and 32 MHz and waits for the oscillator (and PLL)
+ *                   to settle.  Timer1 then free runs, no interrupt.
+ * Note             :The PLL only works from the 4 and 8 MHz INTOSC
+ *                   settings
+ ********************************************************************/
+void ClockInit(void) {
+#if CLOCK_FOSC == 4000000UL || CLOCK_FOSC == 16000000UL
+    OSCCONbits.IRCF2 = 1; // 4 MHz
+    OSCCONbits.IRCF1 = 1;
+    OSCCONbits.IRCF0 = 0;
+#else
+    OSCCONbits.IRCF2 = 1; // 8 MHz
+    OSCCONbits.IRCF1 = 1;
+    OSCCONbits.IRCF0 = 1;
+#endif
+    while (!OSCCONbits.IOFS); // INTOSC stable
+#if CLOCK_FOSC >= 16000000UL
+    OSCTUNEbits.PLLEN = 1; // x4
+    DelayTcy(ClockTcy(2000UL)); // PLL lock time, 2 ms max
+#else
+    OSCTUNEbits.PLLEN = 0;
+#endif
+
+    TMR1H = 0; // latched, written together with TMR1L
+    TMR1L = 0;
+    T1CON = 0b10000001 | (CLOCK_T1CKPS << 4); // 16 bit reads, internal clock, on
+}
+
+/*********************************************************************
+ * Function         :unsigned int ClockStamp(void)
+ * PreCondition     :ClockInit() has been called
+ * Input            :None
+ * Output           :Timer1, 1 count per microsecond
+ * Side Effects     :None
+ * Overview         :ClockRead(), so the two bytes belong together at any
+ *                   priority
+ * Note             :Subtract two stamps as unsigned int for the time
+ *                   between them
+ ********************************************************************/
+unsigned int ClockStamp(void) {
+    unsigned int t;
+
+    ClockRead(t);
+    return t;
+}
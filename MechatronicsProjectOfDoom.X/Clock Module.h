@@ -0,0 +1,97 @@
+/*********************************************************************
+ * FileName:        Clock Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * The one place the clock speed is set.  Every delay, timer reload and
+ * peripheral divider in the project is worked out from CLOCK_FOSC at
+ * compile time, and the modules #error out if a setting can't meet
+ * its minimum timing at that speed.
+ *
+ * Internal oscillator only (#pragma config OSC = INTIO67):
+ *   4000000    INTOSC 4 MHz
+ *   8000000    INTOSC 8 MHz
+ *   16000000   INTOSC 4 MHz with the 4x PLL
+ *   32000000   INTOSC 8 MHz with the 4x PLL
+ *
+ * Timer1 runs free at 1 count per microsecond for time stamps, see
+ * ClockStamp().  Differences of two stamps are good up to 65 ms.
+ * Timer2 runs at CLOCK_T2_US for the PWM and the LCD queue, see
+ * XLCDQueueInit().
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __CLOCK_MODULE_H
+#define __CLOCK_MODULE_H
+
+#ifndef CLOCK_FOSC
+#define CLOCK_FOSC          4000000UL
+#endif
+
+#if CLOCK_FOSC != 4000000UL && CLOCK_FOSC != 8000000UL && CLOCK_FOSC != 16000000UL && CLOCK_FOSC != 32000000UL
+#error "CLOCK_FOSC must be 4, 8, 16 or 32 MHz"
+#endif
+
+#define CLOCK_TCY_PER_US    (CLOCK_FOSC / 4000000UL)        // instruction cycles per microsecond
+
+#define ClockTcy(us)        ((us) * CLOCK_TCY_PER_US)       // instruction cycles in us microseconds
+#define ClockTcyNs(ns)      (((ns) * CLOCK_TCY_PER_US + 999) / 1000) // in ns nanoseconds, rounded up
+
+// Waits at least n instruction cycles (n a constant up to 2 550 000) with the
+// coarsest C18 Delays routine that can count it, rounding up.  The tests are
+// all on constants so only one call is left in the code.  Needs <delays.h>.
+#define DelayTcy(n) do { \
+        if ((n) <= 2550UL) Delay10TCYx((unsigned char) (((n) + 9) / 10)); \
+        else if ((n) <= 25500UL) Delay100TCYx((unsigned char) (((n) + 99) / 100)); \
+        else if ((n) <= 255000UL) Delay1KTCYx((unsigned char) (((n) + 999) / 1000)); \
+        else Delay10KTCYx((unsigned char) (((n) + 9999) / 10000)); \
+    } while (0)
+
+// Timer1 prescaler that makes one count a microsecond
+#if CLOCK_TCY_PER_US == 1
+#define CLOCK_T1CKPS        0b00
+#elif CLOCK_TCY_PER_US == 2
+#define CLOCK_T1CKPS        0b01
+#elif CLOCK_TCY_PER_US == 4
+#define CLOCK_T1CKPS        0b10
+#else
+#define CLOCK_T1CKPS        0b11
+#endif
+
+// Timer2 period, shared by the CCP PWM (Motor Module) and, with a 1:2
+// postscale, the LCD queue tick.  100 us = 10 kHz PWM.
+#define CLOCK_T2_US         100
+#define CLOCK_T2TCY         ClockTcy(CLOCK_T2_US)
+#if CLOCK_T2TCY <= 256
+#define CLOCK_T2PRE         1
+#define CLOCK_T2CKPS        0b00
+#elif CLOCK_T2TCY <= 1024
+#define CLOCK_T2PRE         4
+#define CLOCK_T2CKPS        0b01
+#elif CLOCK_T2TCY <= 4096
+#define CLOCK_T2PRE         16
+#define CLOCK_T2CKPS        0b10
+#else
+#error "CLOCK_T2_US is too long for Timer2 at this clock"
+#endif
+#define CLOCK_PR2           (CLOCK_T2TCY / CLOCK_T2PRE - 1)
+#if CLOCK_T2TCY % CLOCK_T2PRE
+#error "CLOCK_T2_US is not a whole number of Timer2 counts at this clock"
+#endif
+
+// Timer1 into v (unsigned int), from anywhere.  Reading TMR1L latches
+// TMR1H, and a high priority interrupt that reads TMR1L between the two
+// reads would latch a later TMR1H, so GIEH is cleared over them and put
+// back as it was (in high_isr it stays clear).  ClockReadHigh() is the
+// same without the GIEH, for inside high_isr only.
+#define ClockRead(v)        do { unsigned char _gieh = INTCONbits.GIEH; INTCONbits.GIEH = 0; \
+                                (v) = TMR1L; (v) |= (unsigned int) TMR1H << 8; \
+                                INTCONbits.GIEH = _gieh; } while (0)
+#define ClockReadHigh(v)    do { (v) = TMR1L; (v) |= (unsigned int) TMR1H << 8; } while (0)
+
+void ClockInit(void); // Switch to CLOCK_FOSC and start Timer1, first thing in main()
+unsigned int ClockStamp(void); // Microseconds, free running, wraps every 65.536 ms
+
+#endif
@@ -0,0 +1,126 @@
+/*********************************************************************
+ * FileName:        Door Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Door control loop, see Door Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Door Module.h"
+#include "Filter Module.h"
+#include "Event Module.h"
+
+FilterMed3_t _vDoorFilter;
+int _vDoorReading; //last DoorSample(), filtered
+char _vDoorDetected; //  and IRDetectUpdate() on it
+char _vDoorFresh; //DoorSample() has a result DoorDetect() hasn't put out
+char _vDoorBeam; //last one put out, posted as EV_BEAM_... when it changes
+
+/*********************************************************************
+ * Function         :void DoorInit(void)
+ * PreCondition     :Whatever LockBolt() and DoorBeamOut() drive is set up
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Stops the bolt, beam output off
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void DoorInit(void) {
+    IRDetectInit();
+    FilterMed3Init(&_vDoorFilter, 0);
+    _vDoorReading = 0;
+    _vDoorDetected = 0;
+    _vDoorFresh = 0;
+    _vDoorBeam = 0;
+    DoorBeamOut(0);
+    EventInit();
+    LockInit();
+}
+
+/*********************************************************************
+ * Function         :int DoorSample(int raw, unsigned char seq)
+ * PreCondition     :DoorInit() has been called
+ * Input            :raw - ADC reading
+ *                   seq - its sequence number from ADCNext()
+ * Output           :The reading through the median of 3
+ * Side Effects     :None
+ * Overview         :Drops single sample spikes and runs IR Module on
+ *                   the result, so every sample counts however many
+ *                   come in at once.  DoorDetect() puts out the newest
+ *                   state.
+ * Note             :Call it once per new sequence number, in order
+ ********************************************************************/
+int DoorSample(int raw, unsigned char seq) {
+    _vDoorReading = FilterMed3(&_vDoorFilter, raw);
+    _vDoorDetected = IRDetectUpdate(_vDoorReading, seq);
+    _vDoorFresh = 1;
+    return _vDoorReading;
+}
+
+/*********************************************************************
+ * Function         :void DoorDetect(void)
+ * PreCondition     :DoorInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :DoorBeamOut() after every DoorSample()
+ * Overview         :The detector's state as of the last DoorSample() out
+ *                   on the pin, and an event when it changes.  Nothing
+ *                   to do without a new reading.
+ * Note             :None
+ ********************************************************************/
+void DoorDetect(void) {
+    if (!_vDoorFresh)
+        return;
+    _vDoorFresh = 0;
+    DoorBeamOut(_vDoorDetected);
+    if (_vDoorDetected != _vDoorBeam) {
+        _vDoorBeam = _vDoorDetected;
+        EventPost(EVQ_MAIN, _vDoorBeam ? EV_BEAM_BROKEN : EV_BEAM_CLEAR);
+    }
+}
+
+/*********************************************************************
+ * Function         :void DoorRun(void)
+ * PreCondition     :DoorInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :LockBolt() from the lock's actions
+ * Overview         :Runs whatever events are waiting, from all three
+ *                   queues, through the lock state machine
+ * Note             :Main loop only, like EventGet()
+ ********************************************************************/
+void DoorRun(void) {
+    unsigned char event;
+
+    while ((event = EventGet()) != EV_NONE)
+        LockDispatch(event);
+}
+
+/*********************************************************************
+ * Function         :int DoorReading(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :Last filtered reading, 0 before the first
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+int DoorReading(void) {
+    return _vDoorReading;
+}
+
+/*********************************************************************
+ * Function         :char DoorBeam(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :1 while the beam is broken, as last posted
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+char DoorBeam(void) {
+    return _vDoorBeam;
+}
@@ -0,0 +1,43 @@
+/*********************************************************************
+ * FileName:        Door Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * The door's control loop with the hardware taken out: IR readings in,
+ * the beam output and the lock state machine out.  The tasks in the
+ * main file are the hardware side, they take each reading with
+ * ADCNext() and pass it to DoorSample(), and call DoorDetect() and
+ * DoorRun() every 1 ms and LockTick() every LOCK_TICK_MS:
+ *
+ *   DoorSample()   median of 3 filter, then IR Module on every reading,
+ *                  so a late task that drains several loses none
+ *   DoorDetect()   DoorBeamOut() with the newest result,
+ *                  EV_BEAM_BROKEN/CLEAR posted when it changes
+ *   DoorRun()      every event waiting through LockDispatch()
+ *
+ * The outputs go through DoorBeamOut() and LockBolt(), which the
+ * application provides, the same as for Lock Module.  Nothing in here
+ * touches a register, so tools/doorreplay builds this file and the
+ * modules under it with gcc and plays ADC traces through them at
+ * simulated time.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __DOOR_MODULE_H
+#define __DOOR_MODULE_H
+#include "IR Module.h"
+#include "Lock Module.h"
+
+void DoorInit(void); // Beam clear, lock LOCKED, queues empty; calls LockBolt()
+int DoorSample(int raw, unsigned char seq); // New reading from ADCNext(), returns it filtered
+void DoorDetect(void); // Every 1 ms, puts out the detector state after the last DoorSample()
+void DoorRun(void); // Every 1 ms, empties the event queues into the lock
+int DoorReading(void); // Last filtered reading
+char DoorBeam(void); // 1 while the beam is broken
+
+// Provided by the application
+void DoorBeamOut(char on); // Detector output, RA1 on the board
+
+#endif
@@ -0,0 +1,90 @@
+/*********************************************************************
+ * FileName:        Event Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Event queues, see Event Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Event Module.h"
+
+#if EVQ_SIZE & (EVQ_SIZE - 1) || EVQ_SIZE > 128
+#error "EVQ_SIZE must be a power of 2, up to 128"
+#endif
+
+unsigned char _vEvQueue[EVQ_COUNT][EVQ_SIZE];
+volatile unsigned char _vEvHead[EVQ_COUNT]; //events posted, free running, writer only
+volatile unsigned char _vEvTail[EVQ_COUNT]; //events taken, free running, reader only
+
+unsigned char EventOverflows[EVQ_COUNT];
+
+/*********************************************************************
+ * Function         :void EventInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :Call before the interrupts that post are enabled
+ ********************************************************************/
+void EventInit(void) {
+    unsigned char q;
+
+    for (q = 0; q < EVQ_COUNT; q++) {
+        _vEvHead[q] = 0;
+        _vEvTail[q] = 0;
+        EventOverflows[q] = 0;
+    }
+}
+
+/*********************************************************************
+ * Function         :char EventPost(unsigned char queue, unsigned char event)
+ * PreCondition     :EventInit() has been called
+ * Input            :queue - EVQ_HIGH, EVQ_LOW or EVQ_MAIN, whichever
+ *                   belongs to the caller's context
+ *                   event - EV_...
+ * Output           :1 if queued, 0 if the queue was full
+ * Side Effects     :None
+ * Overview         :Fills the slot, then publishes it by moving the
+ *                   head, so the reader never sees a half written slot.
+ * Note             :Only ever post to a queue from its own context
+ ********************************************************************/
+char EventPost(unsigned char queue, unsigned char event) {
+    unsigned char head = _vEvHead[queue];
+
+    if ((unsigned char) (head - _vEvTail[queue]) >= EVQ_SIZE) {
+        if (EventOverflows[queue] != 255)
+            EventOverflows[queue]++;
+        return 0;
+    }
+    _vEvQueue[queue][head & (EVQ_SIZE - 1)] = event;
+    _vEvHead[queue] = head + 1;
+    return 1;
+}
+
+/*********************************************************************
+ * Function         :unsigned char EventGet(void)
+ * PreCondition     :EventInit() has been called
+ * Input            :None
+ * Output           :Oldest event in the most urgent queue that has one,
+ *                   EV_NONE if they are all empty
+ * Side Effects     :None
+ * Overview         :Reads the slot, then frees it by moving the tail
+ * Note             :Main loop only
+ ********************************************************************/
+unsigned char EventGet(void) {
+    unsigned char q, tail, event;
+
+    for (q = 0; q < EVQ_COUNT; q++) {
+        tail = _vEvTail[q];
+        if (tail != _vEvHead[q]) {
+            event = _vEvQueue[q][tail & (EVQ_SIZE - 1)];
+            _vEvTail[q] = tail + 1;
+            return event;
+        }
+    }
+    return EV_NONE;
+}
@@ -0,0 +1,48 @@
+/*********************************************************************
+ * FileName:        Event Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Event queues between the interrupts and the main loop, and the one
+ * list of events in the project.
+ *
+ * There is a queue per context that posts: high_isr, low_isr and the
+ * main loop (tasks).  Each queue has exactly one writer and one reader,
+ * the writer only moves the head and the reader only the tail, and
+ * both are single bytes, so nothing needs interrupts turned off.  A
+ * full queue drops the event and counts it in EventOverflows[].
+ *
+ * EventGet() always empties the high_isr queue first, then low_isr,
+ * then the tasks', oldest first within each.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __EVENT_MODULE_H
+#define __EVENT_MODULE_H
+
+// Queues, by who posts into them (most urgent first)
+#define EVQ_HIGH        0       // high_isr
+#define EVQ_LOW         1       // low_isr
+#define EVQ_MAIN        2       // tasks
+#define EVQ_COUNT       3
+#define EVQ_SIZE        8       // Events per queue, must be a power of 2 (up to 128)
+
+// Events
+#define EV_NONE         0       // EventGet(): nothing waiting
+#define EV_KEY_VALID    1       // Keycard swipe in keyCombos[]
+#define EV_KEY_INVALID  2       // Keycard swipe that isn't
+#define EV_CODE         3       // Button sequence entered
+#define EV_BEAM_BROKEN  4       // IR beam blocked (IR_DETECTED)
+#define EV_BEAM_CLEAR   5       // ... and clear again
+#define EV_TIMEOUT      6       // Lock timer ran out
+#define EV_COUNT        7
+
+void EventInit(void); // Empties the queues and clears EventOverflows[]
+char EventPost(unsigned char queue, unsigned char event); // Not EV_NONE, returns 0 if the queue was full
+unsigned char EventGet(void); // Next event or EV_NONE, main loop only
+
+extern unsigned char EventOverflows[EVQ_COUNT]; // Events dropped per queue, stops at 255
+
+#endif
@@ -0,0 +1,181 @@
+/*********************************************************************
+ * FileName:        Filter Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Integer ADC filters, see Filter Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Filter Module.h"
+
+// Puts a and b in order, the same compare every time, the swap only if they're out of order
+#define FILTER_SORT(a,b)    { if ((a) > (b)) { t = (a); (a) = (b); (b) = t; } }
+
+/*********************************************************************
+ * Function         :void FilterAvgInit(FilterAvg_t *f, int seed)
+ * PreCondition     :None
+ * Input            :f - filter state
+ *                   seed - value to start the average at
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Fills every tap with seed so the first outputs
+ *                   aren't dragged towards zero.
+ * Note             :None
+ ********************************************************************/
+void FilterAvgInit(FilterAvg_t *f, int seed) {
+    unsigned char i;
+
+    for (i = 0; i < FILTER_AVG_TAPS; i++)
+        f->taps[i] = seed;
+    f->sum = (unsigned int) seed << FILTER_AVG_SHIFT;
+    f->pos = 0;
+}
+
+/*********************************************************************
+ * Function         :int FilterAvg(FilterAvg_t *f, int x)
+ * PreCondition     :FilterAvgInit() has been called on f
+ * Input            :f - filter state
+ *                   x - new reading, 0 - ADC_MAX
+ * Output           :Mean of the last FILTER_AVG_TAPS readings
+ * Side Effects     :None
+ * Overview         :Running sum, the oldest tap comes out as the new
+ *                   one goes in, and the divide is a shift.
+ * Note             :None
+ ********************************************************************/
+int FilterAvg(FilterAvg_t *f, int x) {
+    f->sum += x - f->taps[f->pos];
+    f->taps[f->pos] = x;
+    f->pos = (f->pos + 1) & (FILTER_AVG_TAPS - 1);
+    return f->sum >> FILTER_AVG_SHIFT;
+}
+
+/*********************************************************************
+ * Function         :void FilterIIRInit(FilterIIR_t *f, unsigned char shift, int seed)
+ * PreCondition     :None
+ * Input            :f - filter state
+ *                   shift - 1 - FILTER_IIR_MAXSHIFT, time constant is
+ *                   about 2^shift samples
+ *                   seed - value to start the output at
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Larger shifts are clipped to FILTER_IIR_MAXSHIFT
+ * Note             :None
+ ********************************************************************/
+void FilterIIRInit(FilterIIR_t *f, unsigned char shift, int seed) {
+    if (shift > FILTER_IIR_MAXSHIFT)
+        shift = FILTER_IIR_MAXSHIFT;
+    f->shift = shift;
+    f->acc = (unsigned int) seed << shift;
+}
+
+/*********************************************************************
+ * Function         :int FilterIIR(FilterIIR_t *f, int x)
+ * PreCondition     :FilterIIRInit() has been called on f
+ * Input            :f - filter state
+ *                   x - new reading, 0 - ADC_MAX
+ * Output           :Filtered value
+ * Side Effects     :None
+ * Overview         :acc += x - acc/2^shift, output acc/2^shift.  The
+ *                   accumulator keeps the bits a plain y += (x-y)>>shift
+ *                   would throw away, so it settles on x exactly.
+ * Note             :Run time depends on shift, not on the data
+ ********************************************************************/
+int FilterIIR(FilterIIR_t *f, int x) {
+    f->acc += x - (f->acc >> f->shift);
+    return f->acc >> f->shift;
+}
+
+/*********************************************************************
+ * Function         :void FilterMed3Init(FilterMed3_t *f, int seed)
+ * PreCondition     :None
+ * Input            :f - filter state
+ *                   seed - value to fill the window with
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void FilterMed3Init(FilterMed3_t *f, int seed) {
+    f->taps[0] = f->taps[1] = f->taps[2] = seed;
+    f->pos = 0;
+}
+
+/*********************************************************************
+ * Function         :int FilterMed3(FilterMed3_t *f, int x)
+ * PreCondition     :FilterMed3Init() has been called on f
+ * Input            :f - filter state
+ *                   x - new reading
+ * Output           :Median of the last 3 readings
+ * Side Effects     :None
+ * Overview         :Three compare/swaps on a copy of the window.  Gets
+ *                   rid of single sample spikes without smearing edges.
+ * Note             :Up to 3 swaps, a few cycles each
+ ********************************************************************/
+int FilterMed3(FilterMed3_t *f, int x) {
+    int a, b, c, t;
+
+    f->taps[f->pos] = x;
+    if (++f->pos == 3)
+        f->pos = 0;
+    a = f->taps[0];
+    b = f->taps[1];
+    c = f->taps[2];
+    FILTER_SORT(a, b);
+    FILTER_SORT(b, c);
+    FILTER_SORT(a, b);
+    return b;
+}
+
+/*********************************************************************
+ * Function         :void FilterMed5Init(FilterMed5_t *f, int seed)
+ * PreCondition     :None
+ * Input            :f - filter state
+ *                   seed - value to fill the window with
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void FilterMed5Init(FilterMed5_t *f, int seed) {
+    unsigned char i;
+
+    for (i = 0; i < 5; i++)
+        f->taps[i] = seed;
+    f->pos = 0;
+}
+
+/*********************************************************************
+ * Function         :int FilterMed5(FilterMed5_t *f, int x)
+ * PreCondition     :FilterMed5Init() has been called on f
+ * Input            :f - filter state
+ *                   x - new reading
+ * Output           :Median of the last 5 readings
+ * Side Effects     :None
+ * Overview         :Seven compare/swaps on a copy of the window, only
+ *                   enough to get the middle one in place.  Gets rid of
+ *                   spikes up to 2 samples long.
+ * Note             :Up to 7 swaps, a few cycles each
+ ********************************************************************/
+int FilterMed5(FilterMed5_t *f, int x) {
+    int p0, p1, p2, p3, p4, t;
+
+    f->taps[f->pos] = x;
+    if (++f->pos == 5)
+        f->pos = 0;
+    p0 = f->taps[0];
+    p1 = f->taps[1];
+    p2 = f->taps[2];
+    p3 = f->taps[3];
+    p4 = f->taps[4];
+    FILTER_SORT(p0, p1);
+    FILTER_SORT(p3, p4);
+    FILTER_SORT(p0, p3);
+    FILTER_SORT(p1, p4);
+    FILTER_SORT(p1, p2);
+    FILTER_SORT(p2, p3);
+    FILTER_SORT(p1, p2);
+    return p2;
+}
@@ -0,0 +1,72 @@
+/*********************************************************************
+ * FileName:        Filter Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Integer filters for ADC readings (0 - ADC_MAX).  No divides, no
+ * multiplies and no loops over the data, so they're safe to run from
+ * the ADC interrupt.  The average and the IIR take the same time
+ * whatever the data.  The medians always make the same compares, but
+ * each swap they actually do costs a few cycles more, so their worst
+ * case is every swap taken: 3 for FilterMed3, 7 for FilterMed5.  Each
+ * channel keeps its own state struct, so one filter type can run on
+ * several channels.  tools/filtercheck checks them against floating
+ * point and estimates their cycles.
+ *
+ *   FilterAvg   moving average over 2^FILTER_AVG_SHIFT samples
+ *   FilterIIR   single pole low pass, y += (x - y) / 2^shift
+ *   FilterMed3  median of the last 3 samples
+ *   FilterMed5  median of the last 5 samples
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __FILTER_MODULE_H
+#define __FILTER_MODULE_H
+#include "ADC Module.h"
+
+#ifndef FILTER_AVG_SHIFT
+#define FILTER_AVG_SHIFT    3       // 8 sample moving average
+#endif
+#define FILTER_AVG_TAPS     (1 << FILTER_AVG_SHIFT)
+#define FILTER_IIR_MAXSHIFT (16 - ADC_BITS) // keeps the IIR accumulator inside 16 bits
+
+#if FILTER_AVG_SHIFT > 16 - ADC_BITS
+#error "FILTER_AVG_SHIFT overflows the 16 bit sum at this ADC_BITS"
+#endif
+
+typedef struct {
+    int taps[FILTER_AVG_TAPS];
+    unsigned int sum;
+    unsigned char pos;
+} FilterAvg_t;
+
+typedef struct {
+    unsigned int acc; // output scaled up by 2^shift, keeps the fraction
+    unsigned char shift;
+} FilterIIR_t;
+
+typedef struct {
+    int taps[3];
+    unsigned char pos;
+} FilterMed3_t;
+
+typedef struct {
+    int taps[5];
+    unsigned char pos;
+} FilterMed5_t;
+
+void FilterAvgInit(FilterAvg_t *f, int seed);
+int FilterAvg(FilterAvg_t *f, int x);
+
+void FilterIIRInit(FilterIIR_t *f, unsigned char shift, int seed);
+int FilterIIR(FilterIIR_t *f, int x);
+
+void FilterMed3Init(FilterMed3_t *f, int seed);
+int FilterMed3(FilterMed3_t *f, int x);
+
+void FilterMed5Init(FilterMed5_t *f, int seed);
+int FilterMed5(FilterMed5_t *f, int x);
+
+#endif
@@ -0,0 +1,88 @@
+/*********************************************************************
+ * FileName:        IR Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * IR beam detector, see IR Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "IR Module.h"
+
+unsigned char IRDetectState;
+unsigned int IRDetectAge;
+unsigned int IRDetectRejects;
+unsigned char _vIRseq; //sequence number of the last sample seen
+
+/*********************************************************************
+ * Function         :void IRDetectInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Starts out clear, the first sample only sets the
+ *                   time base.
+ * Note             :None
+ ********************************************************************/
+void IRDetectInit(void) {
+    IRDetectState = IR_CLEAR;
+    IRDetectAge = 0;
+    IRDetectRejects = 0;
+    _vIRseq = 0;
+}
+
+/*********************************************************************
+ * Function         :char IRDetectUpdate(int value, unsigned char seq)
+ * PreCondition     :IRDetectInit() has been called
+ * Input            :value - ADC reading
+ *                   seq - its sequence number from ADCLatest()
+ * Output           :1 while detected (IR_DETECTED or IR_LEAVING)
+ * Side Effects     :None
+ * Overview         :Moves the age on by however many samples went by
+ *                   since the last call, then takes at most one step.
+ * Note             :Needs calling at least once every 255 samples
+ ********************************************************************/
+char IRDetectUpdate(int value, unsigned char seq) {
+    unsigned char elapsed = seq - _vIRseq;
+
+    _vIRseq = seq;
+    if (IRDetectAge <= (unsigned int) (0xFFFF - elapsed)) //saturate
+        IRDetectAge += elapsed;
+
+    switch (IRDetectState) {
+        case IR_CLEAR:
+            if (value > IR_ENTER) {
+                IRDetectState = IR_ENTERING;
+                IRDetectAge = 0;
+            }
+            break;
+        case IR_ENTERING:
+            if (value <= IR_EXIT) {
+                IRDetectState = IR_CLEAR;
+                IRDetectAge = 0;
+                IRDetectRejects++;
+            } else if (IRDetectAge >= IR_DWELL_SAMPLES) {
+                IRDetectState = IR_DETECTED;
+                IRDetectAge = 0;
+            }
+            break;
+        case IR_DETECTED:
+            if (value <= IR_EXIT) {
+                IRDetectState = IR_LEAVING;
+                IRDetectAge = 0;
+            }
+            break;
+        case IR_LEAVING:
+            if (value > IR_ENTER) {
+                IRDetectState = IR_DETECTED;
+                IRDetectAge = 0;
+            } else if (IRDetectAge >= IR_RELEASE_SAMPLES) {
+                IRDetectState = IR_CLEAR;
+                IRDetectAge = 0;
+            }
+            break;
+    }
+    return IRDetectState >= IR_DETECTED;
+}
@@ -0,0 +1,62 @@
+/*********************************************************************
+ * FileName:        IR Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * IR beam detector.  Fed one ADC sample at a time, never waits.  A
+ * reading has to go above IR_ENTER and then stay above IR_EXIT for
+ * IR_DWELL_MS before it counts as detected; once detected, a reading
+ * at or below IR_EXIT starts a release, which clears it IR_RELEASE_MS
+ * later unless a reading goes back above IR_ENTER first.  Readings
+ * between the two thresholds count towards whichever of the dwell or
+ * the release is under way, and don't start either.
+ *
+ * Time comes from the ADC sequence number, so a sample the main loop
+ * missed still counts towards the dwell.  Nothing in here touches
+ * hardware, tools/irreplay runs the same file against recorded traces.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __IR_MODULE_H
+#define __IR_MODULE_H
+
+#include "ADC Module.h"
+
+// Thresholds are in ADC_BITS units, these defaults are the old 10 bit 1005 and 1000
+#ifndef IR_ENTER
+#define IR_ENTER        ADCScale(1005) // Reading above this starts a detection
+#endif
+#ifndef IR_EXIT
+#define IR_EXIT         ADCScale(1000) // Reading at or below this starts a release
+#endif
+#ifndef IR_DWELL_MS
+#define IR_DWELL_MS     300     // How long it has to stay up to be detected
+#endif
+#ifndef IR_RELEASE_MS
+#define IR_RELEASE_MS   300     // How long it has to stay down to clear
+#endif
+
+#define IR_DWELL_SAMPLES    ((unsigned int)(IR_DWELL_MS * 1000UL / ADC_SAMPLE_US))
+#define IR_RELEASE_SAMPLES  ((unsigned int)(IR_RELEASE_MS * 1000UL / ADC_SAMPLE_US))
+
+#if IR_EXIT > IR_ENTER
+#error "IR_EXIT must not be above IR_ENTER"
+#endif
+
+// Detector states
+#define IR_CLEAR        0
+#define IR_ENTERING     1       // above IR_ENTER, waiting out IR_DWELL_MS
+#define IR_DETECTED     2
+#define IR_LEAVING      3       // at or below IR_EXIT, waiting out IR_RELEASE_MS
+
+void IRDetectInit(void);
+// Feeds in one sample with its ADC sequence number, returns 1 while detected
+char IRDetectUpdate(int value, unsigned char seq);
+
+extern unsigned char IRDetectState; // One of the states above
+extern unsigned int IRDetectAge; // Samples spent in the current state
+extern unsigned int IRDetectRejects; // Detections that dropped out before the dwell ran out
+
+#endif
@@ -0,0 +1,207 @@
+/*********************************************************************
+ * FileName:        Interrupt Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Interrupt dispatch counts, see Interrupt Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include <p18f4520.h>
+#include "Interrupt Module.h"
+#include "Clock Module.h"
+#include "Serial Module.h"
+#include "LCD Format.h"
+
+volatile unsigned int _vIntBegin[INT_LEVELS];
+
+#ifdef INT_STATS_ENABLE
+
+#define INT_LINE        48      // longest dump line, without the CR LF
+
+unsigned long IntCount[INT_SOURCES];
+unsigned long IntTotal[INT_SOURCES];
+volatile unsigned int IntMax[INT_SOURCES];
+volatile unsigned int _vIntRuns[INT_SOURCES];
+volatile unsigned int _vIntTime[INT_SOURCES];
+volatile unsigned int IntPassMax[INT_LEVELS];
+volatile unsigned int IntLatencyMax[INT_LEVELS];
+volatile unsigned int _vIntEntry[INT_LEVELS];
+
+unsigned char _vIntDumpLine = INT_LEVELS + INT_SOURCES; //next line, a level then its sources; all of them when idle
+
+rom char *rom _vIntNames[INT_SOURCES] = {"key", "adc timer", "adc", "wake", "tick", "lcd", "serial"};
+rom char *rom _vIntLevels[INT_LEVELS] = {"high", "low"};
+
+/*********************************************************************
+ * Function         :unsigned int IntRead(volatile unsigned int *v)
+ * PreCondition     :None
+ * Input            :v - a count the interrupts write
+ * Output           :Its value
+ * Side Effects     :None
+ * Overview         :Two bytes, an interrupt can land between them, so
+ *                   read it until two reads agree
+ * Note             :None
+ ********************************************************************/
+unsigned int IntRead(volatile unsigned int *v) {
+    unsigned int x;
+
+    do {
+        x = *v;
+    } while (x != *v);
+    return x;
+}
+
+/*********************************************************************
+ * Function         :void IntAdd(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Moves each source's runs and time since the last
+ *                   call into IntCount[] and IntTotal[], so the ISR
+ *                   never does 32 bit sums.  GIEH is held off over the
+ *                   copy and clear of each source, a few instructions,
+ *                   and put back as it was.
+ * Note             :Main loop only
+ ********************************************************************/
+void IntAdd(void) {
+    unsigned char i, gieh;
+    unsigned int runs, time;
+
+    for (i = 0; i < INT_SOURCES; i++) {
+        gieh = INTCONbits.GIEH;
+        INTCONbits.GIEH = 0;
+        runs = _vIntRuns[i];
+        time = _vIntTime[i];
+        _vIntRuns[i] = 0;
+        _vIntTime[i] = 0;
+        INTCONbits.GIEH = gieh;
+        IntCount[i] += runs;
+        IntTotal[i] += time;
+    }
+}
+
+/*********************************************************************
+ * Function         :void IntReset(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Stops a dump that is going out
+ * Overview         :Every count back to 0
+ * Note             :An interrupt in the middle can leave its own count
+ *                   from just before the reset, no more
+ ********************************************************************/
+void IntReset(void) {
+    unsigned char i;
+
+    IntAdd(); // and throw them away
+    for (i = 0; i < INT_SOURCES; i++) {
+        IntCount[i] = 0;
+        IntTotal[i] = 0;
+        IntMax[i] = 0;
+    }
+    for (i = 0; i < INT_LEVELS; i++) {
+        IntPassMax[i] = 0;
+        IntLatencyMax[i] = 0;
+    }
+    _vIntDumpLine = INT_LEVELS + INT_SOURCES;
+}
+
+/*********************************************************************
+ * Function         :void IntDump(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Starts from the high level, a dump already going
+ *                   out starts over
+ * Note             :None
+ ********************************************************************/
+void IntDump(void) {
+    _vIntDumpLine = 0;
+}
+
+/*********************************************************************
+ * Function         :void IntFmtCycles(unsigned long us)
+ * PreCondition     :LCD Format is pointed somewhere
+ * Input            :us - a time from Timer1
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :In instruction cycles, 65535 if it's more
+ * Note             :None
+ ********************************************************************/
+void IntFmtCycles(unsigned long us) {
+    us *= CLOCK_TCY_PER_US;
+    XLCDFmtUDec(us > 0xFFFF ? 0xFFFF : (unsigned int) us, 0, ' ');
+}
+
+/*********************************************************************
+ * Function         :char IntDrain(void)
+ * PreCondition     :SerialInit() has been called
+ * Input            :None
+ * Output           :1 while there is more of the dump to send
+ * Side Effects     :Uses the LCD Format buffer output
+ * Overview         :IntAdd(), then formats the next line and sends it
+ *                   if it fits in the serial ring, whole lines only.  A level's line
+ *                   comes before its sources'.  Sources that never ran
+ *                   are skipped.  Once the last line is out every
+ *                   count starts again.
+ * Note             :Main loop only
+ ********************************************************************/
+char IntDrain(void) {
+    char line[INT_LINE + 1];
+    unsigned char level, src, i, n;
+    unsigned long count;
+
+    IntAdd();
+    while (_vIntDumpLine < INT_LEVELS + INT_SOURCES) {
+        // high, its sources, low, its sources
+        level = _vIntDumpLine < INT_TICK + 1 ? INT_HIGH : INT_LOW;
+        XLCDFmtToBuf(line, sizeof line);
+        if (_vIntDumpLine == 0 || _vIntDumpLine == INT_TICK + 1) {
+            XLCDFmtRom(_vIntLevels[level]);
+            XLCDFmtRom(" latency ");
+            XLCDFmtUDec(IntRead(&IntLatencyMax[level]), 0, ' ');
+            XLCDFmtRom(" cy pass ");
+            IntFmtCycles(IntRead(&IntPassMax[level]));
+            XLCDFmtRom(" cy");
+        } else {
+            src = _vIntDumpLine - (level == INT_HIGH ? 1 : 2);
+            count = IntCount[src];
+            if (count) {
+                XLCDFmtRom("  ");
+                XLCDFmtRom(_vIntNames[src]);
+                for (i = XLCDFmtCount(); i < 12; i++)
+                    XLCDFmtChar(' ');
+                XLCDFmtRom("n ");
+                XLCDFmtUDec(count > 0xFFFF ? (unsigned int) (count > 0xFFFFFFUL ? count >> 20 : count >> 10)
+                        : (unsigned int) count, 0, ' ');
+                if (count > 0xFFFF)
+                    XLCDFmtChar(count > 0xFFFFFFUL ? 'M' : 'k'); // 1024, 1048576
+                XLCDFmtRom(" mean ");
+                IntFmtCycles(IntTotal[src] / count);
+                XLCDFmtRom(" max ");
+                IntFmtCycles(IntRead(&IntMax[src]));
+                XLCDFmtRom(" cy");
+            }
+        }
+
+        n = XLCDFmtCount();
+        if (n) {
+            if (SerialRoom() < n + 2)
+                return 1; // try again next time
+            for (i = 0; i < n; i++)
+                SerialPut(line[i]);
+            SerialPut('\r');
+            SerialPut('\n');
+        }
+        if (++_vIntDumpLine == INT_LEVELS + INT_SOURCES)
+            IntReset();
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*********************************************************************
+ * FileName:        Interrupt Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Interrupt sources, the level each one runs at, the order they are
+ * served in, and what they cost.
+ *
+ * High priority is kept for what can't wait: keycard edges (the data
+ * pin is only valid for a few us after the clock falls) and the ADC
+ * (a late Timer3 start skews the sample).  high_isr comes back through
+ * the shadow registers with retfie fast, so its own entry and exit are
+ * the cheap ones.  Everything that only has to happen within a period
+ * or so, the scheduler tick and motor ramp included, is low priority:
+ * its time is added to the keycard's and ADC's worst case only through
+ * the high interrupts' own passes, never the other way round.  The
+ * exceptions are the few instructions low_isr holds GIEH off for: the
+ * Timer0 reload and tick count in SchedTimerISR() and each Timer1
+ * stamp (ClockRead()).
+ *
+ *   source         level   flag            handler
+ *   INT_KEY        high    RBIF            KeyISR()
+ *   INT_ADC_TIMER  high    TMR3IF          ADCTimerISR()
+ *   INT_ADC        high    ADIF            ADCSampleISR()
+ *   INT_WAKE       high    INT0IF          PowerWakeISR() (INT0 is always high)
+ *   INT_TICK       low     TMR0IF          SchedTimerISR(), MotorRampISR()
+ *   INT_LCD        low     TMR2IF          XLCDQueueISR()
+ *   INT_SERIAL     low     TXIF            SerialTxISR()
+ *
+ * The list is the registration: each module's Init sets its IP bit to
+ * the level here, and each ISR dispatches its sources in this order,
+ * highest first, in a loop that starts again from the top after every
+ * handler.  So whatever is most urgent of what is pending goes next,
+ * an edge that comes in while the ADC is being served is seen straight
+ * after it, without the exit and a second entry, and the ISR only
+ * returns once nothing at its level is pending:
+ *
+ *   IntEnter(INT_HIGH);
+ *   for (;;) {
+ *       IntDispatch(INT_HIGH, INT_KEY, INTCONbits.RBIF && INTCONbits.RBIE,
+ *               KeyISR(IntBegin(INT_HIGH)));
+ *       ...
+ *       break; // nothing pending
+ *   }
+ *   IntExit(INT_HIGH);
+ *
+ * IntDispatch() is a bare if with a continue in it, it has to sit
+ * directly in the loop.  Every handler has to clear its flag (or its
+ * enable), or the loop never ends.  IntBegin(level) is the Timer1
+ * stamp taken just before the handler, in us.
+ *
+ * With INT_STATS_ENABLE each dispatch also counts, per source, how
+ * often it ran, the time in the handler and the longest one, and per
+ * level the longest ISR pass, entry to exit, all from Timer1.  The ISR
+ * only keeps 16 bit counts and maxima; IntDrain() adds the counts into
+ * the 32 bit totals and clears them, so it has to come round at least
+ * every 65 ms (the time in the handlers can't add up to more).  Times
+ * are stored in us and reported in instruction cycles, so at more than
+ * 4 MHz they come in steps of CLOCK_TCY_PER_US.  The latency of each
+ * level is measured in hardware, by reading a timer that counts
+ * instruction cycles from the overflow that set its flag:
+ *   high   Timer3 (ADC trigger), IntLatency() before ADCTimerISR()
+ *   low    Timer0 (scheduler tick), IntLatency() before SchedTimerISR()
+ * which is everything between the flag and the handler: the interrupt
+ * response, the context save, whatever was running at the same or a
+ * higher level, and the dispatch ahead of it.  The worst seen for each
+ * is what a keycard edge or any other source at that level can expect.
+ * About 30 cycles a dispatch; without INT_STATS_ENABLE only the stamp
+ * for IntBegin() is left.
+ *
+ * IntDump() sends them out of the serial port, a line at a time from
+ * IntDrain(), then starts them again:
+ *
+ *   high latency 92 cy pass 310 cy
+ *     key       n 1840 mean 41 max 64 cy
+ *     adc timer n 61k mean 38 max 45 cy  (k = 1024, M = 1048576)
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __INTERRUPT_MODULE_H
+#define __INTERRUPT_MODULE_H
+#include "Clock Module.h"
+
+#define INT_STATS_ENABLE        // Comment out to compile the counters out
+
+// Levels
+#define INT_HIGH        0
+#define INT_LOW         1
+#define INT_LEVELS      2
+
+// Sources, in dispatch order, the high ones first
+#define INT_KEY         0
+#define INT_ADC_TIMER   1
+#define INT_ADC         2
+#define INT_WAKE        3
+#define INT_TICK        4       // first low source
+#define INT_LCD         5
+#define INT_SERIAL      6
+#define INT_SOURCES     7
+
+extern volatile unsigned int _vIntBegin[INT_LEVELS]; //Timer1 before the handler being run
+
+// Timer1 into v, level is a constant: in low_isr a high interrupt could
+// latch TMR1H between the two reads, see ClockRead()
+#define IntStamp(level, v) do { if ((level) == INT_HIGH) ClockReadHigh(v); else ClockRead(v); } while (0)
+#define IntBegin(level) (_vIntBegin[level])
+
+#ifdef INT_STATS_ENABLE
+extern unsigned long IntCount[INT_SOURCES]; // Handler runs, as of the last IntDrain()
+extern unsigned long IntTotal[INT_SOURCES]; //   time in them, us
+extern volatile unsigned int IntMax[INT_SOURCES]; //   the longest, us
+extern volatile unsigned int _vIntRuns[INT_SOURCES]; //runs since IntDrain() last added them in
+extern volatile unsigned int _vIntTime[INT_SOURCES]; //  time in them, us
+extern volatile unsigned int IntPassMax[INT_LEVELS]; // Longest ISR pass, us
+extern volatile unsigned int IntLatencyMax[INT_LEVELS]; // Longest flag to handler, cycles
+extern volatile unsigned int _vIntEntry[INT_LEVELS]; //Timer1 at ISR entry
+
+#define IntEnter(level) IntStamp(level, _vIntEntry[level])
+#define IntExit(level)  do { unsigned int _t; IntStamp(level, _t); _t -= _vIntEntry[level]; \
+                          if (_t > IntPassMax[level]) IntPassMax[level] = _t; } while (0)
+// lo, hi: a timer that counts cycles from the overflow that set the flag
+#define IntLatency(level, lo, hi) do { unsigned int _t = (lo); _t |= (unsigned int) (hi) << 8; \
+                          if (_t > IntLatencyMax[level]) IntLatencyMax[level] = _t; } while (0)
+#define IntDispatch(level, src, pending, handler) \
+    if (pending) { unsigned int _t; IntStamp(level, _vIntBegin[level]); handler; IntStamp(level, _t); \
+        _t -= _vIntBegin[level]; _vIntRuns[src]++; _vIntTime[src] += _t; \
+        if (_t > IntMax[src]) \
+            IntMax[src] = _t; \
+        continue; }
+
+void IntReset(void); // Clears every count, stops a dump that is going out
+void IntDump(void); // Starts sending the counts out of the serial port
+char IntDrain(void); // Task, every 20 ms or so: adds up the counts, sends the dump as the ring has room, 1 until it is all out
+#else
+#define IntEnter(level)
+#define IntExit(level)
+#define IntLatency(level, lo, hi)
+#define IntDispatch(level, src, pending, handler) \
+    if (pending) { IntStamp(level, _vIntBegin[level]); handler; continue; }
+#define IntReset()
+#define IntDump()
+#define IntDrain() 0
+#endif
+
+#endif
@@ -0,0 +1,175 @@
+/*********************************************************************
+ * FileName:        Keycard Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Keycard reader, see Keycard Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#if defined(__18CXX)
+#include <p18f4520.h>
+#else
+#include "keyhost.h"    // Host (gcc) build against tools/keyreplay
+#endif
+#include "Clock Module.h"
+#include "Scheduler Module.h"
+#include "Keycard Module.h"
+#include "Event Module.h"
+
+#define KEY_GAP_TICKS   (SchedMs(KEY_GAP_US / 1000) + 1) // more is a gap whatever Timer1 says
+
+rom unsigned char keyCombos[] = {0b00110011, 0b00101010, 0b00111000};
+
+unsigned char _vKeyValid[32]; //bit per code, built from keyCombos[]
+unsigned char _vKeyPins; //RB7:RB4 at the last change
+unsigned char _vKeyShift; //bits of the swipe so far
+unsigned char _vKeyCount; //how many
+unsigned int _vKeyLast; //time stamp of the last clock edge
+unsigned int _vKeyLastTick; //  and SchedNow() then
+unsigned char _vKeyDone; //1 once the swipe's 8 bits are out, 2 once more came
+
+volatile unsigned char _vKeyCode; //last full swipe
+volatile unsigned char _vKeyResult; //KEY_VALID or KEY_INVALID
+volatile unsigned char _vKeySeq; //bumped after each swipe is published
+unsigned char _vKeyRead; //_vKeySeq at the last KeyRead()
+
+unsigned int KeyEdges = 0;
+unsigned char KeyErrors = 0;
+
+/*********************************************************************
+ * Function         :void KeyInit(void)
+ * PreCondition     :ClockInit(), SchedInit() and EventInit() have been
+ *                   called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Takes over the PORTB change interrupt
+ * Overview         :Builds the lookup table and enables the change
+ *                   interrupt, RB6/RB7 are left to the debugger.
+ * Note             :None
+ ********************************************************************/
+void KeyInit(void) {
+    unsigned char i, code;
+
+    for (i = 0; i < 32; i++)
+        _vKeyValid[i] = 0;
+    for (i = 0; i < sizeof (keyCombos); i++) {
+        code = keyCombos[i];
+        _vKeyValid[code >> 3] |= 1 << (code & 7);
+    }
+
+    TRISBbits.TRISB4 = 1;
+    TRISBbits.TRISB5 = 1;
+    INTCON2bits.RBPU = 0; // pull ups on, idle high
+    _vKeyPins = PORTB; // ends any mismatch
+    _vKeyCount = 0;
+    _vKeyDone = 0;
+    _vKeyLast = ClockStamp();
+    _vKeyLastTick = SchedNow();
+    _vKeyRead = _vKeySeq;
+    INTCON2bits.RBIP = 1; // high priority
+    INTCONbits.RBIF = 0;
+    INTCONbits.RBIE = 1;
+}
+
+/*********************************************************************
+ * Function         :void KeyISR(unsigned int entry)
+ * PreCondition     :INTCONbits.RBIF is set
+ * Input            :entry - Timer1 (us, as ClockStamp()) just before the call
+ * Output           :None
+ * Side Effects     :Clears INTCONbits.RBIF
+ * Overview         :Reads PORTB once (that's also what clears the
+ *                   mismatch), and on a falling clock edge shifts the
+ *                   data bit in.  The 8th bit is looked up and published
+ *                   and the count starts again, the rest of that swipe
+ *                   is ignored.  Timer1 wraps every 65 ms, so the gap
+ *                   is measured in scheduler ticks first and only taken
+ *                   from Timer1 when they are too few to have wrapped it.
+ * Note             :Call from high_isr, before anything else
+ ********************************************************************/
+void KeyISR(unsigned int entry) {
+    unsigned char pins = PORTB;
+    unsigned char fell = _vKeyPins & ~pins;
+    unsigned char code;
+    unsigned int now;
+
+    INTCONbits.RBIF = 0;
+    _vKeyPins = pins;
+    if (!(fell & KEY_CLOCK_MASK))
+        return;
+
+    KeyEdges++;
+    now = SchedNow();
+    // differences as 16 bit, what they are on the PIC, for a host build
+    if ((unsigned short) (now - _vKeyLastTick) > KEY_GAP_TICKS
+            || (unsigned short) (entry - _vKeyLast) > KEY_GAP_US) {
+        if (_vKeyCount)
+            KeyErrors++; // the last one stopped short
+        _vKeyCount = 0; // new swipe
+        _vKeyDone = 0;
+    }
+    _vKeyLast = entry;
+    _vKeyLastTick = now;
+
+    if (_vKeyDone) {
+        if (_vKeyDone == 1) {
+            KeyErrors++; // bits past the 8th
+            _vKeyDone = 2;
+        }
+        return;
+    }
+    _vKeyShift = (_vKeyShift << 1) | ((pins & KEY_DATA_MASK) ? 1 : 0);
+    if (++_vKeyCount < KEY_BITS)
+        return;
+
+    _vKeyCount = 0;
+    _vKeyDone = 1;
+    code = _vKeyShift;
+    _vKeyCode = code;
+    _vKeyResult = (_vKeyValid[code >> 3] & (1 << (code & 7))) ? KEY_VALID : KEY_INVALID;
+    _vKeySeq++;
+    EventPost(EVQ_HIGH, _vKeyResult == KEY_VALID ? EV_KEY_VALID : EV_KEY_INVALID);
+}
+
+/*********************************************************************
+ * Function         :char KeyRead(unsigned char *code)
+ * PreCondition     :KeyInit() has been called
+ * Input            :code - where to put the swiped code
+ * Output           :KEY_VALID, KEY_INVALID, or KEY_NONE if there has
+ *                   been no swipe since the last call
+ * Side Effects     :None
+ * Overview         :Code and result are two bytes, read them again if
+ *                   a swipe was published in between.  Also ends a
+ *                   swipe that has been quiet for longer than the gap:
+ *                   Timer1 and the ticks wrap together every 65.5 s,
+ *                   so after just that long KeyISR() alone would take
+ *                   the next one for the rest of it.
+ * Note             :Only the latest swipe is kept.  Call it every
+ *                   KEY_GAP_US or so, the change interrupt is held off
+ *                   for a few instructions.
+ ********************************************************************/
+char KeyRead(unsigned char *code) {
+    unsigned char seq;
+    char result;
+
+    INTCONbits.RBIE = 0; // an edge now waits in RBIF
+    if ((unsigned short) (SchedNow() - _vKeyLastTick) > KEY_GAP_TICKS) {
+        if (_vKeyCount)
+            KeyErrors++;
+        _vKeyCount = 0;
+        _vKeyDone = 0;
+    }
+    INTCONbits.RBIE = 1;
+
+    do {
+        seq = _vKeySeq;
+        *code = _vKeyCode;
+        result = _vKeyResult;
+    } while (seq != _vKeySeq);
+    if (seq == _vKeyRead)
+        return KEY_NONE;
+    _vKeyRead = seq;
+    return result;
+}
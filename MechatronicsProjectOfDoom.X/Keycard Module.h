@@ -0,0 +1,54 @@
+/*********************************************************************
+ * FileName:        Keycard Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Keycard reader on PORTB interrupt-on-change.  The reader gives a
+ * clock and a data line:
+ *   RB4 - card clock, data is valid on its falling edge
+ *   RB5 - card data, 1 = high
+ * A swipe is 8 bits, MSB first.  A gap of more than KEY_GAP_US between
+ * clock edges starts a new swipe, so half a swipe is thrown away and
+ * counted in KeyErrors when the next one starts.
+ *
+ * The interrupt time stamps every edge with ClockStamp(), shifts the
+ * bit in, and on the 8th bit looks the code up in a 256 bit table built
+ * from keyCombos[] - one test, however many combos there are.  Bits
+ * past the 8th in the same swipe are ignored, the swipe is counted in
+ * KeyErrors.  The gap is timed with SchedNow() as well as Timer1, which
+ * wraps every 65 ms, so the first edge after a long wait always starts
+ * a new swipe.
+ * Each swipe is also posted to EVQ_HIGH as EV_KEY_VALID/EV_KEY_INVALID.
+ *
+ * First in high_isr, so the data pin is read while it is still valid
+ * (see Interrupt Module.h):
+ *   IntDispatch(INT_HIGH, INT_KEY, INTCONbits.RBIF && INTCONbits.RBIE,
+ *           KeyISR(IntBegin(INT_HIGH)));
+ * An edge can wait for whatever high priority handler is running when
+ * it comes, IntLatencyMax[INT_HIGH] is the worst that has been seen.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __KEYCARD_MODULE_H
+#define __KEYCARD_MODULE_H
+
+#define KEY_BITS        8
+#define KEY_GAP_US      20000   // Longest wait between clock edges within one swipe
+#define KEY_CLOCK_MASK  0x10    // RB4
+#define KEY_DATA_MASK   0x20    // RB5
+
+// KeyRead() results
+#define KEY_NONE        0       // nothing new
+#define KEY_VALID       1       // code is one of keyCombos[]
+#define KEY_INVALID     2       // full swipe, unknown code
+
+void KeyInit(void); // RB4/RB5 inputs with pull ups, change interrupt at high priority
+void KeyISR(unsigned int entry); // PORTB changed, entry = Timer1 (us) just before the call
+char KeyRead(unsigned char *code); // Latest swipe once, KEY_NONE after that; every 20 ms or so
+
+extern unsigned int KeyEdges; // Clock edges seen
+extern unsigned char KeyErrors; // Swipes with extra bits or cut short
+
+#endif
@@ -0,0 +1,191 @@
+/*********************************************************************
+ * FileName:        LCD Buffer.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * RAM copy of the display with changed-cell updates, see LCD Buffer.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "LCD Buffer.h"
+
+#define XLCD_CELLS  (XLCD_ROWS * XLCD_COLS)
+
+char _vXLCDbuf[XLCD_CELLS]; //what should be on the display
+char _vXLCDsent[XLCD_CELLS]; //what was last sent to it
+unsigned char _vXLCDcursor = 0xFF; //DDRAM address the LCD will write next, 0xFF if not known
+char _vXLCDall = 0; //resend every cell on the next commit
+
+unsigned long XLCDBufBytesSent = 0;
+unsigned long XLCDBufCmdsSent = 0;
+unsigned long XLCDBufSaved = 0;
+
+/*********************************************************************
+ * Function         :void XLCDBufInit(void)
+ * PreCondition     :XLCDClear() has just been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Both copies are set to blanks to match the cleared
+ *                   display, and the cursor to the home position.
+ * Note             :None
+ ********************************************************************/
+void XLCDBufInit(void) {
+    unsigned char i;
+
+    for (i = 0; i < XLCD_CELLS; i++) {
+        _vXLCDbuf[i] = ' ';
+        _vXLCDsent[i] = ' ';
+    }
+    _vXLCDcursor = 0x00;
+    _vXLCDall = 0;
+}
+
+/*********************************************************************
+ * Function         :void XLCDBufClear(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Blanks the RAM copy only
+ * Note             :Cheaper than XLCDClear() when little was on screen,
+ *                   and it doesn't cost the 1.52 ms clear time
+ ********************************************************************/
+void XLCDBufClear(void) {
+    unsigned char i;
+
+    for (i = 0; i < XLCD_CELLS; i++)
+        _vXLCDbuf[i] = ' ';
+}
+
+/*********************************************************************
+ * Function         :void XLCDBufPut(unsigned char row, unsigned char col, char data)
+ * PreCondition     :None
+ * Input            :row, col - cell, off screen cells are ignored
+ *                   data - character for it
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void XLCDBufPut(unsigned char row, unsigned char col, char data) {
+    if (row < XLCD_ROWS && col < XLCD_COLS)
+        _vXLCDbuf[row * XLCD_COLS + col] = data;
+}
+
+/*********************************************************************
+ * Function         :void XLCDBufPutRamString(unsigned char row, unsigned char col, char *string)
+ * PreCondition     :None
+ * Input            :row, col - cell of the first character
+ *                   string - NUL terminated
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Copies the string in, whatever runs off the end of
+ *                   the row is dropped
+ * Note             :None
+ ********************************************************************/
+void XLCDBufPutRamString(unsigned char row, unsigned char col, char *string) {
+    char *cell;
+
+    if (row >= XLCD_ROWS)
+        return;
+    cell = &_vXLCDbuf[row * XLCD_COLS + col];
+    while (*string && col < XLCD_COLS) {
+        *cell++ = *string++;
+        col++;
+    }
+}
+
+/*********************************************************************
+ * Function         :void XLCDBufPutRomString(unsigned char row, unsigned char col, rom char *string)
+ * PreCondition     :None
+ * Input            :row, col - cell of the first character
+ *                   string - NUL terminated, in program memory
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Same as XLCDBufPutRamString()
+ * Note             :None
+ ********************************************************************/
+void XLCDBufPutRomString(unsigned char row, unsigned char col, rom char *string) {
+    char *cell;
+
+    if (row >= XLCD_ROWS)
+        return;
+    cell = &_vXLCDbuf[row * XLCD_COLS + col];
+    while (*string && col < XLCD_COLS) {
+        *cell++ = *string++;
+        col++;
+    }
+}
+
+/*********************************************************************
+ * Function         :void XLCDBufCommit(void)
+ * PreCondition     :XLCDBufInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Moves the LCD cursor
+ * Overview         :Walks the display and writes every cell that differs
+ *                   from what was last sent.  A set address command is
+ *                   only written when the next changed cell isn't where
+ *                   the LCD's address counter already points.
+ * Note             :Goes through XLCDPut()/XLCDCommand(), so it is
+ *                   queued when the LCD queue is running
+ ********************************************************************/
+void XLCDBufCommit(void) {
+    unsigned char row, col, addr;
+    unsigned char i = 0;
+    unsigned char writes = 0;
+
+    for (row = 0; row < XLCD_ROWS; row++) {
+        for (col = 0; col < XLCD_COLS; col++, i++) {
+            if (_vXLCDbuf[i] == _vXLCDsent[i] && !_vXLCDall)
+                continue;
+            addr = XLCDBufAddr(row, col);
+            if (addr != _vXLCDcursor) {
+                XLCDCommand(0x80 | addr);
+                XLCDBufCmdsSent++;
+                writes++;
+            }
+            XLCDPut(_vXLCDbuf[i]);
+            _vXLCDsent[i] = _vXLCDbuf[i];
+            _vXLCDcursor = addr + 1;
+            XLCDBufBytesSent++;
+            writes++;
+        }
+    }
+    _vXLCDall = 0;
+    XLCDBufSaved += XLCD_ROWS * (XLCD_COLS + 1) - writes;
+}
+
+/*********************************************************************
+ * Function         :void XLCDBufInvalidate(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Call after writing to the LCD behind this module's
+ *                   back, the next commit then
+ *                   rewrites every cell from a known address.
+ * Note             :None
+ ********************************************************************/
+void XLCDBufInvalidate(void) {
+    _vXLCDcursor = 0xFF;
+    _vXLCDall = 1;
+}
+
+/*********************************************************************
+ * Function         :void XLCDBufLoseCursor(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Call after moving the LCD address without touching
+ *                   DDRAM (a CGRAM upload), the next commit starts with
+ *                   a set address but only sends the changed cells.
+ * Note             :None
+ ********************************************************************/
+void XLCDBufLoseCursor(void) {
+    _vXLCDcursor = 0xFF;
+}
@@ -0,0 +1,44 @@
+/*********************************************************************
+ * FileName:        LCD Buffer.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * RAM copy of what should be on the LCD.  Draw into it with the
+ * XLCDBuf functions as often as you like, then XLCDBufCommit() sends
+ * only the characters that differ from what was sent last time, with a
+ * set address command only where the changed cells are not next to
+ * each other.
+ *
+ * Don't mix this with XLCDPut()/XLCDCommand() on the same screen, or
+ * call XLCDBufInvalidate() afterwards so the next commit redraws it all.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __LCD_BUFFER_H
+#define __LCD_BUFFER_H
+#include "LCD Module.h"
+
+// Display geometry - rows 2 and 3 of a 4 line module continue rows 0 and 1
+// in DDRAM, so the address of any cell is worked out from these two
+#define XLCD_ROWS   2
+#define XLCD_COLS   16
+
+#define XLCDBufAddr(row, col)   ((((row) & 1) ? 0x40 : 0x00) + (((row) & 2) ? XLCD_COLS : 0) + (col))
+
+void XLCDBufInit(void); // Call right after XLCDClear(), both copies start out blank
+void XLCDBufClear(void); // Blank the RAM copy, the LCD follows on the next commit
+void XLCDBufPut(unsigned char row, unsigned char col, char data);
+void XLCDBufPutRamString(unsigned char row, unsigned char col, char *string); // clipped at the end of the row
+void XLCDBufPutRomString(unsigned char row, unsigned char col, rom char *string);
+void XLCDBufCommit(void); // Send the changed cells
+void XLCDBufInvalidate(void); // LCD contents unknown, the next commit sends everything
+void XLCDBufLoseCursor(void); // LCD address moved (e.g. CGRAM upload), contents still good
+
+// Bus traffic counters, compare against XLCD_ROWS * (XLCD_COLS + 1) writes per full redraw
+extern unsigned long XLCDBufBytesSent; // characters written
+extern unsigned long XLCDBufCmdsSent; // set address commands written
+extern unsigned long XLCDBufSaved; // writes (characters + commands) saved against a full redraw
+
+#endif
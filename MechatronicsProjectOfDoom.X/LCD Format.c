@@ -0,0 +1,305 @@
+/*********************************************************************
+ * FileName:        LCD Format.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Number formatting without stdio, see LCD Format.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "LCD Format.h"
+#include "LCD Buffer.h"
+
+#define XLCD_FMT_LCD    0
+#define XLCD_FMT_BUF    1
+#define XLCD_FMT_FRAME  2
+
+char _vXLCDfmode = XLCD_FMT_LCD; //where XLCDFmtEmit() sends characters
+char *_vXLCDfbuf; //XLCD_FMT_BUF destination
+unsigned char _vXLCDfsize; //  and its size including the NUL
+unsigned char _vXLCDfrow, _vXLCDfcol; //XLCD_FMT_FRAME next cell
+unsigned char _vXLCDfend; //  and the column it stops at
+unsigned char _vXLCDfcount; //characters emitted
+
+rom unsigned int _vXLCDpow10[5] = {10000, 1000, 100, 10, 1};
+rom char _vXLCDhex[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+/*********************************************************************
+ * Function         :static void XLCDFmtEmit(char c)
+ * PreCondition     :None
+ * Input            :c - character
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Sends one character wherever the last XLCDFmtTo
+ *                   call pointed, dropping it if there is no room.
+ * Note             :None
+ ********************************************************************/
+static void XLCDFmtEmit(char c) {
+    switch (_vXLCDfmode) {
+        case XLCD_FMT_LCD:
+            XLCDPut(c);
+            break;
+        case XLCD_FMT_BUF:
+            if (_vXLCDfcount + 1 >= _vXLCDfsize)
+                return; // keep the last byte for the NUL
+            _vXLCDfbuf[_vXLCDfcount] = c;
+            _vXLCDfbuf[_vXLCDfcount + 1] = 0;
+            break;
+        case XLCD_FMT_FRAME:
+            if (_vXLCDfcol >= _vXLCDfend)
+                return;
+            XLCDBufPut(_vXLCDfrow, _vXLCDfcol++, c);
+            break;
+    }
+    _vXLCDfcount++;
+}
+
+/*********************************************************************
+ * Function         :static void XLCDFmtNum(unsigned int value, char neg,
+ *                          unsigned char decimals, unsigned char width, char pad)
+ * PreCondition     :None
+ * Input            :value - magnitude
+ *                   neg - 1 to put a minus sign in front
+ *                   decimals - digits after the point, 0 - 4
+ *                   width, pad - see LCD Format.h
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Works out the five digits by repeated subtraction
+ *                   (at most 45 subtracts), drops leading zeros but
+ *                   keeps one in front of the point.
+ * Note             :None
+ ********************************************************************/
+static void XLCDFmtNum(unsigned int value, char neg, unsigned char decimals, unsigned char width,
+        char pad) {
+    char digits[5];
+    unsigned int p;
+    unsigned char i, first, n;
+
+    for (i = 0; i < 5; i++) {
+        p = _vXLCDpow10[i];
+        digits[i] = '0';
+        while (value >= p) {
+            value -= p;
+            digits[i]++;
+        }
+    }
+
+    if (decimals > 4)
+        decimals = 4;
+    for (first = 0; first < 4 - decimals && digits[first] == '0'; first++);
+    n = 5 - first;
+    if (neg)
+        n++;
+    if (decimals)
+        n++;
+
+    if (pad != '0')
+        for (; width > n; width--)
+            XLCDFmtEmit(pad);
+    if (neg)
+        XLCDFmtEmit('-');
+    for (; width > n; width--)
+        XLCDFmtEmit('0');
+    for (i = first; i < 5; i++) {
+        if (decimals && i == 5 - decimals)
+            XLCDFmtEmit('.');
+        XLCDFmtEmit(digits[i]);
+    }
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtToLCD(void)
+ * PreCondition     :XLCDInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Fields go straight to XLCDPut()
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtToLCD(void) {
+    _vXLCDfmode = XLCD_FMT_LCD;
+    _vXLCDfcount = 0;
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtToBuf(char *buf, unsigned char size)
+ * PreCondition     :None
+ * Input            :buf - destination
+ *                   size - sizeof buf, at least 1
+ * Output           :None
+ * Side Effects     :buf is set to an empty string
+ * Overview         :Fields are appended to buf, at most size - 1
+ *                   characters, and it is always NUL terminated.
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtToBuf(char *buf, unsigned char size) {
+    _vXLCDfmode = XLCD_FMT_BUF;
+    _vXLCDfbuf = buf;
+    _vXLCDfsize = size;
+    _vXLCDfcount = 0;
+    if (size)
+        buf[0] = 0;
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtToFrame(unsigned char row, unsigned char col)
+ * PreCondition     :XLCDBufInit() has been called
+ * Input            :row, col - cell of the first character
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Fields go into the LCD Buffer, anything past the
+ *                   end of the row is dropped.  XLCDBufCommit() sends it.
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtToFrame(unsigned char row, unsigned char col) {
+    XLCDFmtToField(row, col, XLCD_COLS - col);
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtToField(unsigned char row, unsigned char col,
+ *                          unsigned char width)
+ * PreCondition     :XLCDBufInit() has been called
+ * Input            :row, col - cell of the first character
+ *                   width - cells it may use
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :XLCDFmtToFrame() cut off after width cells, or at
+ *                   the end of the row if that comes first
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtToField(unsigned char row, unsigned char col, unsigned char width) {
+    _vXLCDfmode = XLCD_FMT_FRAME;
+    _vXLCDfrow = row;
+    _vXLCDfcol = col;
+    _vXLCDfend = col + width;
+    if (_vXLCDfend > XLCD_COLS || _vXLCDfend < col)
+        _vXLCDfend = XLCD_COLS;
+    _vXLCDfcount = 0;
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtUDec(unsigned int value, unsigned char width, char pad)
+ * PreCondition     :One of the XLCDFmtTo functions has been called
+ * Input            :value - 0 - 65535
+ *                   width, pad - see LCD Format.h
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Unsigned decimal, right aligned in width
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtUDec(unsigned int value, unsigned char width, char pad) {
+    XLCDFmtNum(value, 0, 0, width, pad);
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtDec(int value, unsigned char width, char pad)
+ * PreCondition     :One of the XLCDFmtTo functions has been called
+ * Input            :value - -32768 - 32767
+ *                   width, pad - see LCD Format.h
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Signed decimal, right aligned in width
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtDec(int value, unsigned char width, char pad) {
+    if (value < 0)
+        XLCDFmtNum(-(unsigned int) value, 1, 0, width, pad);
+    else
+        XLCDFmtNum(value, 0, 0, width, pad);
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtFixed(int value, unsigned char decimals,
+ *                          unsigned char width, char pad)
+ * PreCondition     :One of the XLCDFmtTo functions has been called
+ * Input            :value - fixed point value scaled by 10^decimals
+ *                   decimals - digits after the point, 0 - 4
+ *                   width, pad - see LCD Format.h, the point counts
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :-5 with 2 decimals comes out as "-0.05"
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtFixed(int value, unsigned char decimals, unsigned char width, char pad) {
+    if (value < 0)
+        XLCDFmtNum(-(unsigned int) value, 1, decimals, width, pad);
+    else
+        XLCDFmtNum(value, 0, decimals, width, pad);
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtHex(unsigned int value, unsigned char digits)
+ * PreCondition     :One of the XLCDFmtTo functions has been called
+ * Input            :value - number to show
+ *                   digits - 1 - 4, the low digits are shown
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Hex, always exactly digits wide, zero padded
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtHex(unsigned int value, unsigned char digits) {
+    if (digits > 4)
+        digits = 4;
+    while (digits) {
+        digits--;
+        XLCDFmtEmit(_vXLCDhex[(value >> (digits << 2)) & 0x0F]);
+    }
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtChar(char c)
+ * PreCondition     :One of the XLCDFmtTo functions has been called
+ * Input            :c - character
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtChar(char c) {
+    XLCDFmtEmit(c);
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtRam(char *string)
+ * PreCondition     :One of the XLCDFmtTo functions has been called
+ * Input            :string - NUL terminated, in RAM
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtRam(char *string) {
+    while (*string)
+        XLCDFmtEmit(*string++);
+}
+
+/*********************************************************************
+ * Function         :void XLCDFmtRom(rom char *string)
+ * PreCondition     :One of the XLCDFmtTo functions has been called
+ * Input            :string - NUL terminated literal, in program memory
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void XLCDFmtRom(rom char *string) {
+    while (*string)
+        XLCDFmtEmit(*string++);
+}
+
+/*********************************************************************
+ * Function         :unsigned char XLCDFmtCount(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :Characters written since the last XLCDFmtTo call,
+ *                   not counting the ones cut off
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+unsigned char XLCDFmtCount(void) {
+    return _vXLCDfcount;
+}
@@ -0,0 +1,46 @@
+/*********************************************************************
+ * FileName:        LCD Format.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Number formatting without stdio.  Pick where the characters go with
+ * one of the XLCDFmtTo functions, then build the text a field at a
+ * time:
+ *
+ *   XLCDFmtToFrame(1, 0);
+ *   XLCDFmtRom("IR ");
+ *   XLCDFmtUDec(ir1, 4, ' ');      // "IR  998"
+ *
+ * Output to a buffer is always NUL terminated and cut off at the size
+ * given, output to the frame buffer is cut off at the end of the row
+ * (or of the field, XLCDFmtToField()).
+ * Decimal conversion is done by subtracting powers of ten, there's no
+ * divide on the PIC18 and the library one is slow.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __LCD_FORMAT_H
+#define __LCD_FORMAT_H
+#include "LCD Module.h"
+
+// Where the output goes
+void XLCDFmtToLCD(void); // XLCDPut() at the current LCD address
+void XLCDFmtToBuf(char *buf, unsigned char size); // buf[size], NUL terminated, never overrun
+void XLCDFmtToFrame(unsigned char row, unsigned char col); // LCD Buffer cells from row, col
+void XLCDFmtToField(unsigned char row, unsigned char col, unsigned char width); // same, width cells at most
+
+// Fields.  width is the minimum number of characters, 0 for as many as it
+// takes, and pad is ' ' or '0' (a '0' pad goes after the minus sign)
+void XLCDFmtUDec(unsigned int value, unsigned char width, char pad);
+void XLCDFmtDec(int value, unsigned char width, char pad);
+void XLCDFmtFixed(int value, unsigned char decimals, unsigned char width, char pad); // 1234, 2 -> "12.34"
+void XLCDFmtHex(unsigned int value, unsigned char digits); // digits 1 - 4, upper case
+void XLCDFmtChar(char c);
+void XLCDFmtRam(char *string);
+void XLCDFmtRom(rom char *string);
+
+unsigned char XLCDFmtCount(void); // Characters written since the last XLCDFmtTo call
+
+#endif
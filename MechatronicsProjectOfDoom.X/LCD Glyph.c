@@ -0,0 +1,126 @@
+/*********************************************************************
+ * FileName:        LCD Glyph.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * CGRAM slot manager and bar graph, see LCD Glyph.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "LCD Glyph.h"
+#include "LCD Buffer.h"
+
+rom unsigned char *_vXLCDslot[XLCD_GLYPH_SLOTS]; //pattern loaded in each slot, 0 if none
+unsigned int _vXLCDslotUsed[XLCD_GLYPH_SLOTS]; //_vXLCDglyphClock when each slot was last asked for
+unsigned int _vXLCDglyphClock;
+
+unsigned long XLCDGlyphHits = 0;
+unsigned long XLCDGlyphUploads = 0;
+
+// Bar graph cells with 1 - 4 columns filled from the left
+rom unsigned char _vXLCDbar1[8] = {0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00};
+rom unsigned char _vXLCDbar2[8] = {0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00};
+rom unsigned char _vXLCDbar3[8] = {0x00, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x00};
+rom unsigned char _vXLCDbar4[8] = {0x00, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x00};
+rom unsigned char *rom _vXLCDbars[4] = {_vXLCDbar1, _vXLCDbar2, _vXLCDbar3, _vXLCDbar4};
+
+/*********************************************************************
+ * Function         :void XLCDGlyphInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Forgets what's in CGRAM, every glyph is uploaded
+ *                   again the first time it's asked for.
+ * Note             :Call again if the LCD is reinitialised
+ ********************************************************************/
+void XLCDGlyphInit(void) {
+    unsigned char i;
+
+    for (i = 0; i < XLCD_GLYPH_SLOTS; i++) {
+        _vXLCDslot[i] = 0;
+        _vXLCDslotUsed[i] = 0;
+    }
+    _vXLCDglyphClock = 0;
+}
+
+/*********************************************************************
+ * Function         :unsigned char XLCDGlyph(rom unsigned char *pattern)
+ * PreCondition     :XLCDGlyphInit() has been called
+ * Input            :pattern - 8 bytes in ROM
+ * Output           :Character code 0 - 7 that shows it
+ * Side Effects     :On a miss the LCD address ends up in CGRAM, the
+ *                   LCD Buffer is told to set it again before its next
+ *                   write
+ * Overview         :Patterns are matched by address, so each one must
+ *                   be a single ROM array.  A miss takes an empty slot
+ *                   or else the one asked for longest ago.
+ * Note             :None
+ ********************************************************************/
+unsigned char XLCDGlyph(rom unsigned char *pattern) {
+    unsigned char i, slot = 0;
+    unsigned int age, oldest = 0;
+
+    _vXLCDglyphClock++;
+    for (i = 0; i < XLCD_GLYPH_SLOTS; i++) {
+        if (_vXLCDslot[i] == pattern) {
+            _vXLCDslotUsed[i] = _vXLCDglyphClock;
+            XLCDGlyphHits++;
+            return i;
+        }
+        age = _vXLCDslot[i] ? _vXLCDglyphClock - _vXLCDslotUsed[i] : 0xFFFF; // empty slots first
+        if (age > oldest) {
+            oldest = age;
+            slot = i;
+        }
+    }
+
+    XLCDCommand(0x40 | (slot << 3)); // CGRAM address of the slot's top row
+    for (i = 0; i < 8; i++)
+        XLCDPut(pattern[i]);
+    XLCDBufLoseCursor();
+    _vXLCDslot[slot] = pattern;
+    _vXLCDslotUsed[slot] = _vXLCDglyphClock;
+    XLCDGlyphUploads++;
+    return slot;
+}
+
+/*********************************************************************
+ * Function         :void XLCDBarGraph(unsigned char row, unsigned char col,
+ *                          unsigned char cells, unsigned int value, unsigned int max)
+ * PreCondition     :XLCDGlyphInit() and XLCDBufInit() have been called
+ * Input            :row, col - leftmost cell
+ *                   cells - width of the bar, up to 51
+ *                   value - 0 - max, larger values show a full bar
+ *                   max - value for a full bar
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Full cells use the character ROM block, so only the
+ *                   one partly filled cell needs a glyph.  The cells go
+ *                   into the LCD Buffer, XLCDBufCommit() sends them.
+ * Note             :One divide per call
+ ********************************************************************/
+void XLCDBarGraph(unsigned char row, unsigned char col, unsigned char cells,
+        unsigned int value, unsigned int max) {
+    unsigned int steps;
+    unsigned char i;
+
+    if (!max)
+        return;
+    if (value > max)
+        value = max;
+    steps = (unsigned int) (((unsigned long) value * ((unsigned int) cells * 5) + max / 2) / max);
+
+    for (i = 0; i < cells; i++, col++) {
+        if (steps >= 5) {
+            XLCDBufPut(row, col, XLCD_FULL_BLOCK);
+            steps -= 5;
+        } else if (steps) {
+            XLCDBufPut(row, col, XLCDGlyph(_vXLCDbars[steps - 1]));
+            steps = 0;
+        } else
+            XLCDBufPut(row, col, ' ');
+    }
+}
@@ -0,0 +1,41 @@
+/*********************************************************************
+ * FileName:        LCD Glyph.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Custom characters.  The HD44780 has 8 CGRAM slots, character codes
+ * 0 - 7.  Patterns live in ROM (8 rows, low 5 bits used, top row
+ * first) and XLCDGlyph() hands back the code for one, uploading it
+ * over the least recently used slot only if it isn't loaded already.
+ *
+ *   rom unsigned char bell[8] = {0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00};
+ *   XLCDBufPut(0, 15, XLCDGlyph(bell));
+ *
+ * Re-uploading a slot changes every cell on screen showing that code,
+ * so a screen can't use more than 8 different glyphs at once.  Code 0
+ * can't go in a string, use XLCDBufPut() for glyphs.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __LCD_GLYPH_H
+#define __LCD_GLYPH_H
+#include "LCD Module.h"
+
+#define XLCD_GLYPH_SLOTS    8
+#define XLCD_FULL_BLOCK     0xFF    // all dots on, in the character ROM
+
+void XLCDGlyphInit(void); // All slots empty, call after XLCDInit()
+unsigned char XLCDGlyph(rom unsigned char *pattern); // Code 0 - 7 showing pattern
+
+// Draws value / max as a bar cells wide into the LCD Buffer at row, col,
+// 5 steps per cell.  Uses up to 4 glyphs.
+void XLCDBarGraph(unsigned char row, unsigned char col, unsigned char cells,
+        unsigned int value, unsigned int max);
+
+// Counters, one per XLCDGlyph() call
+extern unsigned long XLCDGlyphHits; // already loaded
+extern unsigned long XLCDGlyphUploads; // had to upload, 9 LCD writes each
+
+#endif
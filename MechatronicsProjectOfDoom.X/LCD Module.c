@@ -45,13 +45,32 @@
  ********************************************************************/
 
 #include "LCD Module.h"
+#include "Trace Module.h"
 char _vXLCDreg = 0; //Used as a flag to check if from XLCDInit()
+char _vXLCDlong = 0; //Last instruction was clear/home (1.52 ms instead of 37 us)
+char _vXLCDnobf = 0; //Busy flag never cleared once, stop polling and use the delays
+
+#ifdef  XLCD_QUEUE
+// Transmit queue, filled by XLCDPut()/XLCDCommand() and emptied by XLCDQueueISR()
+unsigned char _vXLCDqdata[XLCD_QUEUE_SIZE];
+char _vXLCDqrs[XLCD_QUEUE_SIZE];
+volatile unsigned char _vXLCDqhead = 0; //next free slot, only moved by the main line
+volatile unsigned char _vXLCDqtail = 0; //next byte to send, only moved by the interrupt
+unsigned char _vXLCDqwait = 0; //ticks to sit out before the module is free again
+char _vXLCDqrun = 0; //Set by XLCDQueueInit(), writes go through the queue from then on
+unsigned int XLCDQueueDrops = 0;
+#endif
 
 // Prototypes added by DSF 5/18/08 as well as functions at the end of .c file
 void XLCDDelay15ms(void);
 void XLCDDelay4ms(void);
 void XLCD_Delay500ns(void);
 void XLCDDelay(void);
+static void XLCDBusyFallback(void);
+static void XLCDWrite(char rs, unsigned char value);
+#ifdef  XLCD_QUEUE
+static void XLCDQueueWrite(char rs, unsigned char value);
+#endif
 
 /*********************************************************************
  * Function         : void XLCDInit(void)
@@ -64,6 +83,10 @@ void XLCDDelay(void);
  *                    LCD controller.
  ********************************************************************/
 void XLCDInit(void) {
+#ifdef  XLCD_QUEUE
+    XLCDFlush(); // don't talk over the interrupt if it is still draining
+#endif
+
     // Add by DSF 9/26/08
     //  You need these three lines for the PICDEM 2 Board only
     //  If you are using an external LCD wire you can get back RD7 for IO
@@ -202,9 +225,16 @@ void XLCDInit(void) {
  * Output           : None
  * Side Effects     : None
  * Overview         : None
- * Note             : None
+ * Note             : Only queued once XLCDQueueInit() has been called
  ********************************************************************/
 void XLCDCommand(unsigned char cmd) {
+#ifdef  XLCD_QUEUE
+    if (_vXLCDqrun && _vXLCDreg == 0) {
+        XLCDQueueWrite(0, cmd);
+        return;
+    }
+#endif
+
     if (_vXLCDreg == 1) //if  called from XLCDinit routine is always Blocking
     {
 #ifdef  XLCD_DELAYMODE
@@ -228,25 +258,7 @@ void XLCDCommand(unsigned char cmd) {
 #endif
     }
 
-    XLCD_RSPIN = 0;
-    XLCD_ENPIN = 0;
-#ifndef XLCD_RW_GROUND
-    XLCD_RWPIN = 0;
-#endif
-
-
-    XLCD_DATAPORT &= 0xF0; //clear port
-    XLCD_DATAPORT |= ((cmd >> 4)&0x0f);
-    XLCD_ENPIN = 1; // Clock the cmd in
-    XLCD_Delay500ns();
-    XLCD_ENPIN = 0;
-
-    XLCD_DATAPORT &= 0xF0; //clear port
-    XLCD_DATAPORT |= cmd & 0x0f; //shift left 4 times
-    XLCD_ENPIN = 1;
-    XLCD_Delay500ns();
-    XLCD_ENPIN = 0;
-
+    XLCDWrite(0, cmd);
     return;
 }
 
@@ -257,9 +269,16 @@ void XLCDCommand(unsigned char cmd) {
  * Output           :None
  * Side Effects     :None
  * Overview         :None
- * Note             :None
+ * Note             :Only queued once XLCDQueueInit() has been called
  ********************************************************************/
 void XLCDPut(char data) {
+#ifdef  XLCD_QUEUE
+    if (_vXLCDqrun) {
+        XLCDQueueWrite(1, data);
+        return;
+    }
+#endif
+
 #ifdef  XLCD_BLOCK
 #ifdef  XLCD_DELAYMODE
     XLCDDelay();
@@ -269,14 +288,40 @@ void XLCDPut(char data) {
 #endif
 #endif
 
+    XLCDWrite(1, data);
+    return;
+}
 
+/*********************************************************************
+ * Function         :static void XLCDWrite(char rs, unsigned char value)
+ * PreCondition     :The module is not busy
+ * Input            :rs - 0 for an instruction, 1 for data
+ *                   value - byte to clock out
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Clocks one byte into the module without any waiting,
+ *                   shared by XLCDCommand(), XLCDPut() and the queue
+ *                   interrupt.  XLCD_LATWRITE builds each edge as a whole
+ *                   LATD value and stores it, no read-modify-write of
+ *                   PORTD and no call per strobe.
+ * Note             :XLCD_LATWRITE owns all of PORTD
+ ********************************************************************/
+static void XLCDWrite(char rs, unsigned char value) {
+#ifdef XLCD_LATWRITE
+    unsigned char lat;
+
+    // RW low, EN low, power bit as it is, RS and the data nibble all in one store
+    lat = (XLCD_LATCH & XLCD_PWR_MASK) | (rs ? XLCD_RS_MASK : 0);
+    XLCDStrobe(lat | (value >> 4));
+    XLCDStrobe(lat | (value & 0x0F));
+#else
 #ifndef XLCD_RW_GROUND
     XLCD_RWPIN = 0;
 #endif
-    XLCD_RSPIN = 1;
+    XLCD_RSPIN = rs;
     XLCD_ENPIN = 0;
 #ifdef XLCD_8BIT
-    XLCD_DATAPORT = data;
+    XLCD_DATAPORT = value;
     XLCD_ENPIN = 1;
     XLCD_Delay500ns();
     XLCD_ENPIN = 0;
@@ -284,35 +329,35 @@ void XLCDPut(char data) {
 #ifdef XLCD_4BIT
 #ifdef XLCD_UPPER
     XLCD_DATAPORT &= 0x0f; //clear port
-    XLCD_DATAPORT |= data & 0xf0; //write upper nibble to port
+    XLCD_DATAPORT |= value & 0xf0; //write upper nibble to port
     XLCD_ENPIN = 1; // Clock the cmd in
     XLCD_Delay500ns();
     XLCD_ENPIN = 0;
 
     XLCD_DATAPORT &= 0x0f; //clear port
-    XLCD_DATAPORT |= (data << 4)&0xf0; //shift left 4 times
+    XLCD_DATAPORT |= (value << 4)&0xf0; //shift left 4 times
     XLCD_ENPIN = 1;
     XLCD_Delay500ns();
     XLCD_ENPIN = 0;
 #endif
 #ifdef XLCD_LOWER
     XLCD_DATAPORT &= 0xF0; //clear port
-    XLCD_DATAPORT |= ((data >> 4)&0x0f);
+    XLCD_DATAPORT |= ((value >> 4)&0x0f);
     XLCD_ENPIN = 1; // Clock the cmd in
     XLCD_Delay500ns();
     XLCD_ENPIN = 0;
 
     XLCD_DATAPORT &= 0xF0; //clear port
-    XLCD_DATAPORT |= data & 0x0f; //shift left 4 times
+    XLCD_DATAPORT |= value & 0x0f; //shift left 4 times
     XLCD_ENPIN = 1;
     XLCD_Delay500ns();
     XLCD_ENPIN = 0;
 #endif  
-
-
-
+#endif
 #endif
 
+    // clear (0x01) and return home (0x02/0x03) are the slow ones
+    _vXLCDlong = (rs == 0 && value < 0x04);
     return;
 }
 
@@ -331,6 +376,14 @@ void XLCDPut(char data) {
  * Note             :None
  ********************************************************************/
 char XLCDIsBusy(void) {
+    unsigned int tries = XLCD_BUSY_TIMEOUT;
+
+    if (_vXLCDnobf) // busy flag is not readable, wait out the worst case instead
+    {
+        XLCDDelay();
+        return 0;
+    }
+
     XLCD_RSPIN = 0;
     XLCD_RWPIN = 1;
     XLCD_ENPIN = 0;
@@ -343,19 +396,23 @@ char XLCDIsBusy(void) {
 
     if (_vXLCDreg == 1) //will execute only if  called from XLCDInit
     {
-        while (XLCD_DATAPORT & 0x80);
+        while ((XLCD_DATAPORT & 0x80) && --tries);
         XLCD_ENPIN = 0;
         XLCD_DATAPORT_TRIS = 0x00; //make port output
-        return;
+        if (tries == 0)
+            XLCDBusyFallback();
+        return 0;
     }
 
 #ifdef  XLCD_BLOCK  
     if (_vXLCDreg == 0) // will execute only if not called from XLCDInit
     {
-        while (XLCD_DATAPORT & 0x80);
+        while ((XLCD_DATAPORT & 0x80) && --tries);
         XLCD_ENPIN = 0;
         XLCD_DATAPORT_TRIS = 0x00; //make port input
-        return;
+        if (tries == 0)
+            XLCDBusyFallback();
+        return 0;
     }
 #endif
 
@@ -388,27 +445,31 @@ char XLCDIsBusy(void) {
     XLCD_Delay500ns();
     if (_vXLCDreg == 1) // will execute only if  called from XLCDInit
     {
-        while (XLCD_DATAPORT & 0x80);
+        while ((XLCD_DATAPORT & 0x80) && --tries);
         XLCD_ENPIN = 0;
         XLCD_Delay500ns();
         XLCD_ENPIN = 1;
         XLCD_Delay500ns();
         XLCD_ENPIN = 0;
         XLCD_DATAPORT_TRIS &= 0x0F; //make upper port output
-        return;
+        if (tries == 0)
+            XLCDBusyFallback();
+        return 0;
     }
 
 #ifdef  XLCD_BLOCK    
     if (_vXLCDreg == 0) // When not called from the XLCDInit
     {
-        while (XLCD_DATAPORT & 0x80);
+        while ((XLCD_DATAPORT & 0x80) && --tries);
         XLCD_ENPIN = 0;
         XLCD_Delay500ns();
         XLCD_ENPIN = 1;
         XLCD_Delay500ns();
         XLCD_ENPIN = 0;
         XLCD_DATAPORT_TRIS &= 0x0F; //make upper port output
-        return;
+        if (tries == 0)
+            XLCDBusyFallback();
+        return 0;
     }
 #endif
 
@@ -446,26 +507,30 @@ char XLCDIsBusy(void) {
     XLCD_Delay500ns();
     if (_vXLCDreg == 1) // will execute only if  called from XLCDInit
     {
-        while (XLCD_DATAPORT & 0x08);
+        while ((XLCD_DATAPORT & 0x08) && --tries);
         XLCD_ENPIN = 0;
         XLCD_Delay500ns();
         XLCD_ENPIN = 1;
         XLCD_Delay500ns();
         XLCD_ENPIN = 0;
         XLCD_DATAPORT_TRIS &= 0xF0; //make port output
-        return;
+        if (tries == 0)
+            XLCDBusyFallback();
+        return 0;
     }
 #ifdef XLCD_BLOCK 
     if (_vXLCDreg == 0) //will execute only if  called from XLCDInit
     {
-        while (XLCD_DATAPORT & 0x08);
+        while ((XLCD_DATAPORT & 0x08) && --tries);
         XLCD_ENPIN = 0;
         XLCD_Delay500ns();
         XLCD_ENPIN = 1;
         XLCD_Delay500ns();
         XLCD_ENPIN = 0;
         XLCD_DATAPORT_TRIS &= 0xF0; //make port output
-        return;
+        if (tries == 0)
+            XLCDBusyFallback();
+        return 0;
     }
 #endif
 
@@ -496,6 +561,25 @@ char XLCDIsBusy(void) {
 #endif 
 #endif 
 
+    return 0;
+}
+
+/*********************************************************************
+ * Function         :static void XLCDBusyFallback(void)
+ * PreCondition     :A busy flag poll in XLCDIsBusy() ran out of tries
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Busy flag polling is switched off for good
+ * Overview         :If the busy flag does not clear within XLCD_BUSY_TIMEOUT
+ *                   polls the module is either not answering reads (RW tied
+ *                   low, no LCD fitted) or something is badly wrong, so stop
+ *                   spending the timeout on every byte and fall back to the
+ *                   per-instruction worst case timings of XLCDDelay().
+ * Note             :None
+ ********************************************************************/
+static void XLCDBusyFallback(void) {
+    _vXLCDnobf = 1;
+    XLCDDelay();
 }
 
 /*********************************************************************
@@ -512,6 +596,9 @@ char XLCDIsBusy(void) {
 unsigned char XLCDGetAddr(void)
  {
     char addr = 0;
+#ifdef  XLCD_QUEUE
+    XLCDFlush();
+#endif
 #ifdef  XLCD_BLOCK
 #ifdef  XLCD_DELAYMODE
     XLCDDelay();
@@ -582,6 +669,9 @@ unsigned char XLCDGetAddr(void)
  ********************************************************************/
 char XLCDGet(void) {
     char data = 0;
+#ifdef  XLCD_QUEUE
+    XLCDFlush();
+#endif
 #ifdef  XLCD_BLOCK
 #ifdef  XLCD_DELAYMODE
     XLCDDelay();
@@ -673,6 +763,7 @@ void XLCDPutRomString(rom char *string) {
  * Note             :is lways blocking till the string is written fully
  ********************************************************************/
 void XLCDPutRamString(char *string) {
+    TraceBegin(TR_LCD_PUT);
     while (*string) // Write data to LCD up to null
     {
 #ifdef  XLCD_NONBLOCK
@@ -682,49 +773,194 @@ void XLCDPutRamString(char *string) {
         XLCDPut(*string); // Write character to LCD
         string++; // Increment buffer
     }
+    TraceEnd(TR_LCD_PUT);
     return;
 }
 
+#ifdef  XLCD_QUEUE
+
+/*********************************************************************
+ * Function         :void XLCDQueueInit(void)
+ * PreCondition     :XLCDInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Starts Timer2 (shared with the PWM, see MotorInit())
+ *                   and takes its interrupt, low priority
+ * Overview         :From here on XLCDPut()/XLCDCommand() (and everything
+ *                   built on them) only store the byte and return, the
+ *                   Timer2 interrupt clocks them out one byte per tick.
+ * Note             :Needs RCONbits.IPEN and INTCONbits.GIEL/GIEH set and
+ *                   XLCDQueueISR() called from low_isr
+ ********************************************************************/
+void XLCDQueueInit(void) {
+    // Timer2 period is CLOCK_T2_US (the PWM period), postscale 1:2 gives XLCD_QUEUE_TICKUS
+    PR2 = CLOCK_PR2;
+    T2CON = 0b00001100 | CLOCK_T2CKPS; // postscale 1:2, timer on
+    IPR1bits.TMR2IP = 0; // low priority
+    PIR1bits.TMR2IF = 0;
+    PIE1bits.TMR2IE = 0; // only enabled while there is something to send
+    _vXLCDqwait = 0;
+    _vXLCDqrun = 1;
+}
+
+/*********************************************************************
+ * Function         :static void XLCDQueueWrite(char rs, unsigned char value)
+ * PreCondition     :XLCDQueueInit() has been called
+ * Input            :rs - 0 for an instruction, 1 for data
+ *                   value - byte to queue
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Adds a byte to the transmit queue and makes sure the
+ *                   Timer2 interrupt is running to send it.
+ * Note             :With XLCD_QUEUE_BLOCK a full queue waits for the
+ *                   interrupt to make room, otherwise the byte is dropped
+ *                   and counted in XLCDQueueDrops.
+ ********************************************************************/
+static void XLCDQueueWrite(char rs, unsigned char value) {
+    unsigned char head = _vXLCDqhead;
+    unsigned char next = (head + 1) & (XLCD_QUEUE_SIZE - 1);
+
+#ifdef  XLCD_QUEUE_BLOCK
+    while (next == _vXLCDqtail) // full, the interrupt frees a slot every tick
+        PIE1bits.TMR2IE = 1;
+#else
+    if (next == _vXLCDqtail) {
+        XLCDQueueDrops++;
+        return;
+    }
+#endif
+    _vXLCDqdata[head] = value;
+    _vXLCDqrs[head] = rs;
+    _vXLCDqhead = next; // publish only once the slot is filled in
+    PIE1bits.TMR2IE = 1;
+}
+
+/*********************************************************************
+ * Function         :void XLCDQueueISR(void)
+ * PreCondition     :PIR1bits.TMR2IF is set
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Clears PIR1bits.TMR2IF
+ * Overview         :Sends the next queued byte once the module has had
+ *                   time to finish the last one (one tick, or 1.52 ms
+ *                   after clear/home). Turns its own interrupt off when
+ *                   the queue runs dry.
+ * Note             :Call from low_isr
+ ********************************************************************/
+void XLCDQueueISR(void) {
+    unsigned char tail = _vXLCDqtail;
+
+    PIR1bits.TMR2IF = 0;
+    if (_vXLCDqwait) {
+        _vXLCDqwait--;
+        return;
+    }
+    if (tail == _vXLCDqhead) {
+        PIE1bits.TMR2IE = 0; // nothing left, XLCDFlush() waits for this
+        return;
+    }
+    XLCDWrite(_vXLCDqrs[tail], _vXLCDqdata[tail]);
+    if (_vXLCDlong)
+        _vXLCDqwait = XLCD_QUEUE_LONGTICKS;
+    _vXLCDqtail = (tail + 1) & (XLCD_QUEUE_SIZE - 1);
+}
+
+/*********************************************************************
+ * Function         :void XLCDFlush(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Waits until everything queued has been sent and
+ *                   executed by the module.
+ * Note             :Interrupts must be on or this never returns
+ ********************************************************************/
+void XLCDFlush(void) {
+    if (!_vXLCDqrun)
+        return;
+    while (PIE1bits.TMR2IE);
+}
+
+#endif
+
 // Timing Functions
-//   Note: If you ever want to use a frequency that is NOT 4 MHz you will need to go into the LCD Module.c file (this file)
-//   and modify these functions (found below).  They are hard coded to cause specific time delays and expect a 4 MHz
-//   clock signal.  They are easy to change but if you aren't at 4 MHz they won't do want they say.
+//   Note: These are worked out from CLOCK_FOSC in Clock Module.h, change the clock there and they follow.
+//   Each one rounds up, so they never come in under the datasheet figure.
 
 /*The user  is require to write this 15 milli second delay in his routine,this delay */
 
 /*is required as it is used in XLCDInit() which is used to initialize the LCD module*/
 void XLCDDelay15ms(void) {
-    // Want 15ms using 4 MHz
-    // 15 000 instructions
-    Delay1KTCYx(15);
+    DelayTcy(ClockTcy(15000UL));
 }
 
 /*The user  is require to write this 4 milli second delay in his routine,this  delay */
 
 /*is required as it is used in XLCDInit() which is used to initialize the LCD module*/
 void XLCDDelay4ms(void) {
-    // Want 4ms using 4 MHz
-    // 4 000 instructions
-    Delay1KTCYx(4);
+    // The datasheet asks for more than 4.1 ms after the first function set
+    DelayTcy(ClockTcy(4100UL));
+}
+
+/*Long enough for any instruction except clear and return home (37 us, 43 us for data writes)*/
+void XLCDDelay100us(void) {
+    DelayTcy(ClockTcy(100UL));
+}
+
+/*Worst case execution time of clear display and return home*/
+void XLCDDelay1520us(void) {
+    DelayTcy(ClockTcy(1520UL));
 }
 
 /*The user  is require to write this 500 nano second in his routine  this  delay */
 
 /*is required as it is used in all read and write commaands in the XLCD routines*/
 void XLCD_Delay500ns(void) {
+    // EN high/low time and address setup are all under 500 ns, the call and return add more
+#if XLCD_NOPS_500NS > 8
+#error "XLCD_Delay500ns() needs more than 8 Nops at this clock"
+#endif
+#if XLCD_NOPS_500NS > 0
     Nop();
+#endif
+#if XLCD_NOPS_500NS > 1
+    Nop();
+#endif
+#if XLCD_NOPS_500NS > 2
+    Nop();
+#endif
+#if XLCD_NOPS_500NS > 3
+    Nop();
+#endif
+#if XLCD_NOPS_500NS > 4
     Nop();
+#endif
+#if XLCD_NOPS_500NS > 5
     Nop();
+#endif
+#if XLCD_NOPS_500NS > 6
+    Nop();
+#endif
+#if XLCD_NOPS_500NS > 7
+    Nop();
+#endif
 }
 
 /*The user  is require to write this XLCDDelay() in his routine,this is required to write if */
 
 /*the mode selected is by delay , it is used in all XLCD read and write commands of this routine */
 void XLCDDelay(void) {
-    // We are using the blocking delay mode (it's the easiest so we need this)
-    // Want at least 2 ms using 4 MHz (DSF picked 2 ms, longer is safer)
-    // 2 000 instructions
-    Delay1KTCYx(2);
+    // Used by the blocking delay mode and as the fallback when the busy flag can't be read.
+    // Only clear display and return home need the 1.52 ms, everything else is done
+    // in 37-43 us so waiting 2 ms per byte (the old DSF value) threw away ~95% of the time
+#ifdef XLCD_FLATDELAY
+    DelayTcy(ClockTcy(2000UL)); // the old value, Delay1KTCYx(2) at 4 MHz
+#else
+    if (_vXLCDlong)
+        XLCDDelay1520us();
+    else
+        XLCDDelay100us();
+#endif
 }
 
 
@@ -46,7 +46,13 @@
 
 #ifndef __LCD_MODULE_H
 #define __LCD_MODULE_H
+#if defined(__18CXX)
+#include <p18cxxx.h>
 #include <delays.h>
+#else
+#include "lcdhost.h"    // Host (gcc) build against the simulated PORTD in tools/lcdsim
+#endif
+#include "Clock Module.h"
 
 // Primary initialization functions
 void XLCDInit(void); // Initialise the LCD, must be done before using any other commands
@@ -60,6 +66,13 @@ void XLCDPutRamString(char *string); // to display a data string from an array o
 void XLCDPutRomString(rom char *string); // to display a const data string (constant are directly typed text stored in ROM)
 
 
+// Interrupt driven output - once XLCDQueueInit() is called the functions above only queue the bytes
+// and return, the Timer2 interrupt (low priority) sends them in the background
+void XLCDQueueInit(void); // Start queueing, call after XLCDInit()
+void XLCDQueueISR(void); // Call from low_isr when PIR1bits.TMR2IF is set
+void XLCDFlush(void); // Wait until everything queued has been written
+extern unsigned int XLCDQueueDrops; // Bytes thrown away because the queue was full (without XLCD_QUEUE_BLOCK)
+
 // Additional cursor related functions
 #define XLCDCursorOnBlinkOn()        XLCDCommand(0x0F)	// the user may refer to the LCD data sheet
 #define XLCDCursorOnBlinkOff()       XLCDCommand(0x0E)	// and generate more commands like these
@@ -78,12 +91,12 @@ char XLCDGet(void);
 #define XLCDReturnHome() 			XLCDCommand(0x02)
 
 // Timing Functions
-//   Note: If you ever want to use a frequency that is NOT 4 MHz you will need to go into the LCD Module.c file
-//   and modify these functions.  They are hard coded to cause specific time delays and expect a 4 MHz
-//   clock signal.  They are easy to change but if you aren't at 4 MHz they won't do want they say.
+//   Note: The delays are worked out from CLOCK_FOSC with DelayTcy(), see Clock Module.h.  Change the
+//   clock there and they follow, there is nothing to edit in LCD Module.c.
 void XLCDDelay15ms(void);
 void XLCDDelay4ms(void);
 void XLCDDelay100us(void);
+void XLCDDelay1520us(void);
 void XLCD_Delay500ns(void);
 void XLCDDelay(void);
 
@@ -97,19 +110,67 @@ void XLCDDelay(void);
 #define XLCD_ENPIN   		PORTDbits.RD6
 #define XLCD_ENPIN_TRIS  	TRISDbits.TRISD6
 #define LCD_PWR				PORTDbits.RD7				// Necessary for PICDEM 2 board
+#define XLCD_LATCH          LATD        // Same port, written whole by XLCD_LATWRITE
+#define XLCD_EN_MASK        0x40
+#define XLCD_RW_MASK        0x20
+#define XLCD_RS_MASK        0x10
+#define XLCD_PWR_MASK       0x80
 
 /* Setup mode for LCD - added by DSF 5/18/08 */
 #define XLCD_4BIT 
-#define    CLOCK_FREQ    .4
 #define    XLCD_2LINE 
 #define    XLCD_FONT5x8    
 #define    XLCD_LOWER                      
 #define    XLCD_BLOCK         
-#define    XLCD_DELAYMODE         
+#if !defined(XLCD_DELAYMODE) && !defined(XLCD_READBFMODE)
+#define    XLCD_READBFMODE      // Poll the busy flag on RD3 (DB7) instead of waiting a fixed delay
+#endif
+// XLCD_FLATDELAY with XLCD_DELAYMODE: the old flat 2 ms per byte in XLCDDelay(), for lcdbench's before figures
+#if !defined(XLCD_PORTWRITE) && !defined(XLCD_LATWRITE)
+#define    XLCD_LATWRITE        // Each nibble is 3 whole-byte LATD stores, XLCD_PORTWRITE for the old bit by bit PORTD path
+#endif
+#define    XLCD_BUSY_TIMEOUT (1000 * CLOCK_TCY_PER_US) // Busy flag polls before giving up, ~6 ms at any clock (about 6 instructions per poll)
+#define    XLCD_QUEUE               // Send through the Timer2 interrupt once XLCDQueueInit() is called
+#define    XLCD_QUEUE_SIZE  64      // Entries (2 bytes of RAM each), must be a power of 2
+#define    XLCD_QUEUE_BLOCK         // Wait for room when the queue is full, comment out to drop and count instead
+#define    XLCD_QUEUE_TICKUS (2 * CLOCK_T2_US) // Timer2 tick, see XLCDQueueInit()
+#define    XLCD_QUEUE_LONGTICKS ((1520 + XLCD_QUEUE_TICKUS - 1) / XLCD_QUEUE_TICKUS - 1) // extra ticks after clear/home
+
+// Worked out from CLOCK_FOSC (Clock Module.h)
+#define    XLCD_NOPS_500NS  ClockTcyNs(500UL)    // Nop()s in XLCD_Delay500ns()
+
+// XLCD_LATWRITE strobes, see XLCDWrite().  One Nop() is at least 500 ns up
+// to 8 MHz, so the Nops only start adding up at the PLL speeds.
+#if XLCD_NOPS_500NS <= 1
+#define    XLCDNop500ns()   Nop()
+#elif XLCD_NOPS_500NS == 2
+#define    XLCDNop500ns()   Nop(); Nop()
+#elif XLCD_NOPS_500NS <= 4
+#define    XLCDNop500ns()   Nop(); Nop(); Nop(); Nop()
+#else
+#define    XLCDNop500ns()   Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop(); Nop()
+#endif
+// Data and RS set up with EN low, EN high for 500 ns, EN low again with
+// the data held, then 500 ns before anything else can move the pins
+#define    XLCDStrobe(lat)  { XLCD_LATCH = (lat); \
+                              XLCD_LATCH = (lat) | XLCD_EN_MASK; XLCDNop500ns(); \
+                              XLCD_LATCH = (lat); XLCDNop500ns(); }
+#if defined(XLCD_LATWRITE) && !(defined(XLCD_4BIT) && defined(XLCD_LOWER))
+#error "XLCD_LATWRITE is only written for the 4 bit lower nibble wiring, use XLCD_PORTWRITE"
+#endif
+
 #define    XLCD_DISPLAYON
 #define    XLCD_CURSORON
 #define    XLCD_BLINKON
 #define    XLCD_CURSOR_INCREMENT
 #define    XLCD_DISPLAY_NOSHIFT
 
+#ifndef XLCD_QUEUE
+#define XLCDFlush()
+#endif
+
+#if defined(XLCD_READBFMODE) && defined(XLCD_RW_GROUND)
+#error "XLCD_READBFMODE needs the RW pin wired up, use XLCD_DELAYMODE with XLCD_RW_GROUND"
+#endif
+
 #endif
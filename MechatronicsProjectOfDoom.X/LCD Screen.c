@@ -0,0 +1,134 @@
+/*********************************************************************
+ * FileName:        LCD Screen.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Screen templates, see LCD Screen.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "LCD Screen.h"
+#include "LCD Format.h"
+#include "LCD Glyph.h"
+
+rom XLCDScreen *_vXLCDscreen = 0; //screen in the LCD Buffer, 0 if none
+
+extern rom unsigned int _vXLCDpow10[5]; //LCD Format.c, 10000 down to 1
+
+/*********************************************************************
+ * Function         :void XLCDScreenShow(rom XLCDScreen *screen)
+ * PreCondition     :XLCDBufInit() has been called
+ * Input            :screen - template, 0 to blank the display
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Copies the fixed text over every cell, fields
+ *                   included, unless the screen is already showing.
+ *                   Call it every time the screen is drawn, it only
+ *                   costs anything when the screen changes.
+ * Note             :Anything drawn over the screen with the LCD Buffer
+ *                   functions stays until the next change of screen
+ ********************************************************************/
+void XLCDScreenShow(rom XLCDScreen *screen) {
+    unsigned char row;
+
+    if (screen == _vXLCDscreen)
+        return;
+    _vXLCDscreen = screen;
+    if (!screen) {
+        XLCDBufClear();
+        return;
+    }
+    for (row = 0; row < XLCD_ROWS; row++)
+        XLCDBufPutRomString(row, 0, screen->text + row * XLCD_COLS);
+}
+
+/*********************************************************************
+ * Function         :char XLCDScreenField(rom XLCDScreen *screen, unsigned char field)
+ * PreCondition     :XLCDScreenShow() has been called
+ * Input            :screen - template the field belongs to
+ *                   field - index in its field table
+ * Output           :1 if the field is showing, 0 if not
+ * Side Effects     :None
+ * Overview         :Blanks the field's cells and points LCD Format at
+ *                   the first one, clipped to the width.
+ * Note             :On 0 LCD Format is left where it was, don't write
+ ********************************************************************/
+char XLCDScreenField(rom XLCDScreen *screen, unsigned char field) {
+    rom XLCDField *f;
+    unsigned char i;
+
+    if (screen != _vXLCDscreen || field >= screen->count)
+        return 0;
+    f = &screen->fields[field];
+    for (i = 0; i < f->width; i++)
+        XLCDBufPut(f->row, f->col + i, ' ');
+    XLCDFmtToField(f->row, f->col, f->width);
+    return 1;
+}
+
+/*********************************************************************
+ * Function         :void XLCDScreenUDec(rom XLCDScreen *screen, unsigned char field,
+ *                          unsigned int value)
+ * PreCondition     :XLCDScreenShow() has been called
+ * Input            :screen, field - see XLCDScreenField()
+ *                   value - 0 - 65535
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Unsigned decimal right aligned in the field, or
+ *                   the field full of '#' if it doesn't fit, rather
+ *                   than the top digits on their own
+ * Note             :None
+ ********************************************************************/
+void XLCDScreenUDec(rom XLCDScreen *screen, unsigned char field, unsigned int value) {
+    unsigned char width, i;
+
+    if (!XLCDScreenField(screen, field))
+        return;
+    width = screen->fields[field].width;
+    if (width && width < 5 && value >= _vXLCDpow10[4 - width]) {
+        for (i = 0; i < width; i++)
+            XLCDFmtChar('#');
+        return;
+    }
+    XLCDFmtUDec(value, width, ' ');
+}
+
+/*********************************************************************
+ * Function         :void XLCDScreenRom(rom XLCDScreen *screen, unsigned char field,
+ *                          rom char *text)
+ * PreCondition     :XLCDScreenShow() has been called
+ * Input            :screen, field - see XLCDScreenField()
+ *                   text - NUL terminated, in program memory
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Left aligned, blanks after it, cut off at the width
+ * Note             :None
+ ********************************************************************/
+void XLCDScreenRom(rom XLCDScreen *screen, unsigned char field, rom char *text) {
+    if (XLCDScreenField(screen, field))
+        XLCDFmtRom(text);
+}
+
+/*********************************************************************
+ * Function         :void XLCDScreenBar(rom XLCDScreen *screen, unsigned char field,
+ *                          unsigned int value, unsigned int max)
+ * PreCondition     :XLCDScreenShow() and XLCDGlyphInit() have been called
+ * Input            :screen, field - see XLCDScreenField()
+ *                   value, max - see XLCDBarGraph()
+ * Output           :None
+ * Side Effects     :Uses up to 4 glyphs
+ * Overview         :Bar graph the width of the field.  Every cell is
+ *                   drawn, so it isn't blanked first.
+ * Note             :None
+ ********************************************************************/
+void XLCDScreenBar(rom XLCDScreen *screen, unsigned char field, unsigned int value,
+        unsigned int max) {
+    rom XLCDField *f;
+
+    if (screen != _vXLCDscreen || field >= screen->count)
+        return;
+    f = &screen->fields[field];
+    XLCDBarGraph(f->row, f->col, f->width, value, max);
+}
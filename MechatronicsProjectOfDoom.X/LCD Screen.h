@@ -0,0 +1,56 @@
+/*********************************************************************
+ * FileName:        LCD Screen.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Screen templates.  A screen is its fixed text, the whole display row
+ * after row, and a table of fields (row, column, width), both in ROM.
+ * XLCDScreenShow() copies the text into the LCD Buffer once, when the
+ * screen changes; after that only the fields are written, each one
+ * blanked and then filled, so the text around them is never formatted
+ * or sent again:
+ *
+ *   #define STATUS_IR  0
+ *   #define STATUS_BAR 1
+ *   rom XLCDField statusFields[] = {{1, 3, 4}, {1, 8, 8}};
+ *   rom XLCDScreen status = {"Door            " "IR              ", statusFields, 2};
+ *
+ *   XLCDScreenShow(&status);
+ *   XLCDScreenUDec(&status, STATUS_IR, ir1);      // right aligned in 4 cells
+ *   XLCDScreenBar(&status, STATUS_BAR, ir1, ADC_MAX);
+ *   XLCDBufCommit();
+ *
+ * Field writes name their screen and do nothing unless it is the one
+ * showing, so a task can update its fields whatever page is up.
+ * XLCDScreenField() points the LCD Format functions at a field for
+ * anything the helpers don't cover.  XLCDBufCommit() still decides what
+ * reaches the LCD, a field that comes out the same costs nothing.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __LCD_SCREEN_H
+#define __LCD_SCREEN_H
+#include "LCD Buffer.h"
+
+typedef struct {
+    unsigned char row;
+    unsigned char col;
+    unsigned char width; // cells, the field is clipped to them
+} XLCDField;
+
+typedef struct {
+    rom char *text; // XLCD_ROWS x XLCD_COLS characters, row 0 first
+    rom XLCDField *fields;
+    unsigned char count; // fields in the table
+} XLCDScreen;
+
+void XLCDScreenShow(rom XLCDScreen *screen); // Draws the text if it isn't already up, 0 for none
+char XLCDScreenField(rom XLCDScreen *screen, unsigned char field); // Blanks it and aims LCD Format at it, 0 if not showing
+void XLCDScreenUDec(rom XLCDScreen *screen, unsigned char field, unsigned int value); // right aligned, #### if too wide
+void XLCDScreenRom(rom XLCDScreen *screen, unsigned char field, rom char *text); // left aligned
+void XLCDScreenBar(rom XLCDScreen *screen, unsigned char field, unsigned int value,
+        unsigned int max); // XLCDBarGraph() across the field
+
+#endif
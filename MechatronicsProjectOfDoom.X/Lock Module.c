@@ -0,0 +1,234 @@
+/*********************************************************************
+ * FileName:        Lock Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Door lock state machine, see Lock Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Lock Module.h"
+
+typedef struct {
+    unsigned char next;
+    char (*guard)(void); // 0 = always
+    void (*action)(void); // 0 = none
+} LockRule_t;
+
+static char Allowed(void);
+static char Expired(void);
+static char ExpiredClear(void);
+static void Unlock(void);
+static void Opened(void);
+static void Entered(void);
+static void Passed(void);
+static void Relock(void);
+static void Locked(void);
+static void Failed(void);
+static void Forgive(void);
+static void Extend(void);
+
+#define STAY(s)         {s, 0, 0}
+
+// [state][event], events in Event Module.h order:
+//   none, card ok, card bad, code, beam broken, beam clear, timeout
+rom LockRule_t lockRules[LOCK_STATES][EV_COUNT] = {
+    { // LOCKED
+        STAY(LOCK_LOCKED),
+        {LOCK_UNLOCKING, Allowed, Unlock},
+        {LOCK_LOCKED, 0, Failed},
+        {LOCK_UNLOCKING, Allowed, Unlock},
+        STAY(LOCK_LOCKED),
+        STAY(LOCK_LOCKED),
+        {LOCK_LOCKED, Expired, Forgive}
+    },
+    { // UNLOCKING
+        STAY(LOCK_UNLOCKING),
+        STAY(LOCK_UNLOCKING),
+        STAY(LOCK_UNLOCKING),
+        STAY(LOCK_UNLOCKING),
+        STAY(LOCK_UNLOCKING),
+        STAY(LOCK_UNLOCKING),
+        {LOCK_UNLOCKED, Expired, Opened}
+    },
+    { // UNLOCKED
+        STAY(LOCK_UNLOCKED),
+        {LOCK_UNLOCKED, 0, Extend},
+        STAY(LOCK_UNLOCKED),
+        {LOCK_UNLOCKED, 0, Extend},
+        {LOCK_OPEN, 0, Entered},
+        {LOCK_UNLOCKED, 0, Passed},
+        {LOCK_LOCKING, ExpiredClear, Relock}
+    },
+    { // OPEN
+        STAY(LOCK_OPEN),
+        STAY(LOCK_OPEN),
+        STAY(LOCK_OPEN),
+        STAY(LOCK_OPEN),
+        STAY(LOCK_OPEN),
+        {LOCK_UNLOCKED, 0, Passed},
+        STAY(LOCK_OPEN)
+    },
+    { // LOCKING
+        STAY(LOCK_LOCKING),
+        {LOCK_UNLOCKING, 0, Unlock},
+        STAY(LOCK_LOCKING),
+        {LOCK_UNLOCKING, 0, Unlock},
+        {LOCK_UNLOCKING, 0, Unlock},
+        STAY(LOCK_LOCKING),
+        {LOCK_LOCKED, Expired, Locked}
+    }
+};
+
+unsigned char _vLockState = LOCK_LOCKED;
+unsigned int _vLockTimer = 0; //LockTick()s left, 0 = not running
+unsigned char _vLockBeam = 0; //beam broken, kept up to date in every state
+
+unsigned char LockFails = 0;
+unsigned int LockIgnored = 0;
+
+/*********************************************************************
+ * Guards and actions for lockRules[]
+ ********************************************************************/
+static char Allowed(void) {
+    return LockFails < LOCK_MAX_FAILS;
+}
+
+// A timeout that was already queued when an action restarted the timer
+// is stale, the timer is running again
+static char Expired(void) {
+    return _vLockTimer == 0;
+}
+
+// ... and don't relock on someone who stepped into the beam while the
+// bolt was still opening, wait for them to clear it
+static char ExpiredClear(void) {
+    return _vLockTimer == 0 && !_vLockBeam;
+}
+
+static void Unlock(void) {
+    LockFails = 0;
+    LockBolt(LOCK_BOLT_OPEN);
+    _vLockTimer = LockTicks(LOCK_BOLT_MS);
+}
+
+static void Opened(void) {
+    LockBolt(LOCK_BOLT_STOP);
+    _vLockTimer = LockTicks(LOCK_WAIT_MS);
+}
+
+static void Entered(void) {
+    _vLockTimer = 0; // stays open as long as the beam is broken
+}
+
+static void Passed(void) {
+    _vLockTimer = LockTicks(LOCK_PASS_MS);
+}
+
+static void Relock(void) {
+    LockBolt(LOCK_BOLT_CLOSE);
+    _vLockTimer = LockTicks(LOCK_BOLT_MS);
+}
+
+static void Locked(void) {
+    LockBolt(LOCK_BOLT_STOP);
+}
+
+static void Failed(void) {
+    if (LockFails < LOCK_MAX_FAILS) // saturate, a wrap to 0 would end the lockout
+        LockFails++;
+    if (LockFails >= LOCK_MAX_FAILS)
+        _vLockTimer = LockTicks(LOCK_LOCKOUT_MS);
+}
+
+static void Forgive(void) {
+    LockFails = 0;
+}
+
+static void Extend(void) {
+    _vLockTimer = LockTicks(LOCK_WAIT_MS);
+}
+
+/*********************************************************************
+ * Function         :void LockInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Calls LockBolt(LOCK_BOLT_STOP)
+ * Overview         :Starts LOCKED, assumes the bolt is home
+ * Note             :None
+ ********************************************************************/
+void LockInit(void) {
+    _vLockState = LOCK_LOCKED;
+    _vLockTimer = 0;
+    _vLockBeam = 0;
+    LockFails = 0;
+    LockIgnored = 0;
+    LockBolt(LOCK_BOLT_STOP);
+}
+
+/*********************************************************************
+ * Function         :void LockDispatch(unsigned char event)
+ * PreCondition     :LockInit() has been called
+ * Input            :event - EV_...
+ * Output           :None
+ * Side Effects     :Whatever the action does
+ * Overview         :Looks up lockRules[state][event].  If there is a
+ *                   guard and it says no, nothing changes.  Otherwise
+ *                   the state moves on and then the action runs, so an
+ *                   action sees the state it is going into.  The beam
+ *                   level is noted first, whatever the state, for the
+ *                   guards.
+ * Note             :Unknown events are ignored
+ ********************************************************************/
+void LockDispatch(unsigned char event) {
+    rom LockRule_t *rule;
+    char (*guard)(void);
+    void (*action)(void);
+
+    if (event >= EV_COUNT)
+        return;
+    if (event == EV_BEAM_BROKEN)
+        _vLockBeam = 1;
+    else if (event == EV_BEAM_CLEAR)
+        _vLockBeam = 0;
+    rule = &lockRules[_vLockState][event];
+    guard = rule->guard;
+    if (guard && !guard()) {
+        LockIgnored++;
+        return;
+    }
+    action = rule->action;
+    _vLockState = rule->next;
+    if (action)
+        action();
+}
+
+/*********************************************************************
+ * Function         :void LockTick(void)
+ * PreCondition     :LockInit() and EventInit() have been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :May post EV_TIMEOUT to EVQ_MAIN
+ * Overview         :Counts the lock timer down
+ * Note             :Task context only (EVQ_MAIN)
+ ********************************************************************/
+void LockTick(void) {
+    if (_vLockTimer && !--_vLockTimer)
+        EventPost(EVQ_MAIN, EV_TIMEOUT);
+}
+
+/*********************************************************************
+ * Function         :unsigned char LockState(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :LOCK_LOCKED ... LOCK_LOCKING
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+unsigned char LockState(void) {
+    return _vLockState;
+}
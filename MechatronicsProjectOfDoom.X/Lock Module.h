@@ -0,0 +1,72 @@
+/*********************************************************************
+ * FileName:        Lock Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * The door lock, as a state machine run from a ROM table.  Every
+ * (state, event) pair has one entry: the next state, an optional guard
+ * that can veto the move, and an optional action.  Dispatching an
+ * event is one table lookup whatever the state, so the time it takes
+ * doesn't grow as events are added.  Pairs that don't matter stay put.
+ *
+ *   LOCKED    --card/code-->     UNLOCKING  (bolt opening)
+ *   UNLOCKING --timeout-->       UNLOCKED   (bolt open, waits for the door)
+ *   UNLOCKED  --beam broken-->   OPEN       (someone in the doorway)
+ *   OPEN      --beam clear-->    UNLOCKED   (short wait, then relocks)
+ *   UNLOCKED  --timeout-->       LOCKING    (bolt closing, once the beam is clear)
+ *   LOCKING   --timeout-->       LOCKED
+ *   LOCKING   --beam/card-->     UNLOCKING  (something in the way)
+ * LOCK_MAX_FAILS bad swipes in a row ignore cards and codes for
+ * LOCK_LOCKOUT_MS.
+ *
+ * Plain C, no registers.  The bolt is moved through LockBolt(), which
+ * the application provides, and time comes from calling LockTick()
+ * every LOCK_TICK_MS, so the same file runs on the host (tools/locksim).
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __LOCK_MODULE_H
+#define __LOCK_MODULE_H
+#include "Event Module.h"
+
+#ifndef __18CXX
+#define rom             // Host build
+#endif
+
+// States
+#define LOCK_LOCKED     0
+#define LOCK_UNLOCKING  1
+#define LOCK_UNLOCKED   2
+#define LOCK_OPEN       3
+#define LOCK_LOCKING    4
+#define LOCK_STATES     5
+
+// LockBolt() moves
+#define LOCK_BOLT_STOP  0
+#define LOCK_BOLT_OPEN  1
+#define LOCK_BOLT_CLOSE 2
+
+// Timing
+#define LOCK_TICK_MS    100     // LockTick() period
+#define LOCK_BOLT_MS    800     // Bolt travel, end to end
+#define LOCK_WAIT_MS    5000    // Unlocked with nobody going through
+#define LOCK_PASS_MS    1000    // After the beam clears, before relocking
+#define LOCK_LOCKOUT_MS 30000   // Cards ignored after too many bad swipes
+#define LOCK_MAX_FAILS  3
+
+#define LockTicks(ms)   ((unsigned int) ((ms) / LOCK_TICK_MS))
+
+void LockInit(void); // LOCKED, bolt stopped
+void LockDispatch(unsigned char event); // Runs one event through the table
+void LockTick(void); // Every LOCK_TICK_MS, posts EV_TIMEOUT to EVQ_MAIN when the timer runs out
+unsigned char LockState(void); // LOCK_...
+
+// Provided by the application
+void LockBolt(unsigned char move); // LOCK_BOLT_...
+
+extern unsigned char LockFails; // Bad swipes in a row, up to LOCK_MAX_FAILS
+extern unsigned int LockIgnored; // Events a guard turned away
+
+#endif
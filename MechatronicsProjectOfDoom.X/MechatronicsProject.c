@@ -12,30 +12,53 @@
 
 /**  Header Files **************************************************/
 #include <p18f4520.h>
-#include <stdio.h>
+#include "Clock Module.h"
 #include <adc.h>
+#include "ADC Module.h"
+#include "Door Module.h"
+#include "Scheduler Module.h"
+#include "Keycard Module.h"
+#include "Sequence Module.h"
+#include "Motor Module.h"
+#include "Serial Module.h"
+#include "Trace Module.h"
+#include "Interrupt Module.h"
+#include "Telemetry Module.h"
+#include "Profile Module.h"
+#include "Power Module.h"
 #include "LCD Module.h"
+#include "LCD Buffer.h"
+#include "LCD Format.h"
+#include "LCD Glyph.h"
+#include "LCD Screen.h"
 #include <portb.h>
 #include <delays.h>
 
 /** Configuration Bits *********************************************/
 #pragma config OSC = INTIO67
-#pragma config WDT = OFF
+#pragma config WDT = OFF // PowerNap() turns it on while asleep
+#pragma config WDTPS = 16 // 4 ms x 16 = POWER_WDT_MS
 #pragma config LVP = OFF
 #pragma config BOREN = OFF
 #pragma config XINST = OFF
 
 /** Define Constants Here ******************************************/
 #define SAMPLE 100
-#define LOCKED 1
-#define UNLOCKED 0
-#define OPEN 0
-#define CLOSED 1
+#define BOLT_SPEED 200 // motor speed while the bolt moves
+#define QUIET_MS 5000 // locked with nothing in front of the sensor this long, sample off the watchdog
 
 /** Local Function Prototypes **************************************/
 void low_isr(void);
 void high_isr(void);
 void sampleFunction(void);
+void taskSample(void);
+void taskDisplay(void);
+void taskKeycard(void);
+void taskButtons(void);
+void taskCommand(void);
+void taskPower(void);
+void idle(void);
+void fullRate(void);
 
 /** Declare Interrupt Vector Sections ****************************/
 #pragma code high_vector=0x08
@@ -51,14 +74,26 @@ void interrupt_at_low_vector(void) {
 }
 
 /** Global Variables ***********************************************/
-//char keycardCombos = {0b00110011, 0b00101010, 0b00111000};
-//char buttonSeq1 = {'a', 'b', 'b', 'c'};
-//char buttonSeq2 = {'b', 'c', 'a', 'a'};
-//char buttonSeq3 = {'a', 'c', 'a', 'c'};
+// Button sequences abbc, bcaa and acac are compiled into Sequence Table.c by tools/seqgen
 
-int ir1;
+unsigned char lastIrSeq = 0;
+unsigned char buttonsRaw = 0, buttonsStable = 0; // RB2:RB0, 1 = pressed
+rom char *rom lockNames[LOCK_STATES] = {"LOCKED", "OPENING", "UNLOCKD", "OPEN", "CLOSING"};
+// Lock screen:  "LOCKED  1 A5 OK "
+//               "IR  998 ########"
+#define LS_STATE    0       // lockNames[]
+#define LS_MATCH    1       // button sequence matched, hex bit mask
+#define LS_KEY      2       // last keycard code and OK/BAD
+#define LS_IR       3       // IR reading
+#define LS_BAR      4       //   and as a bar
+rom XLCDField lockFields[] = {{0, 0, 7}, {0, 8, 1}, {0, 10, 6}, {1, 3, 4}, {1, 8, 8}};
+rom XLCDScreen lockScreen = {"                " "IR              ", lockFields, 5};
+unsigned char profilePage = 0; // LCD shows profile section profilePage - 1, 0 = the lock screen
+char lowPower = 0; // sampling from PowerNap(), ADC on its RC clock
+unsigned int quietMs = 0; // how long taskPower() has seen nothing going on
+unsigned long samplesSeen = 0; // IR readings since the last power report
+char reportDue = 0; // power report asked for, waiting for room in the serial ring
 
-char line1[10];
 
 /*******************************************************************
  * Function:        void main(void)
@@ -66,73 +101,116 @@ char line1[10];
 #pragma code
 
 void main(void) {
-    // Set the clock to 4 MHz
-    OSCCONbits.IRCF2 = 1;
-    OSCCONbits.IRCF1 = 1;
-    OSCCONbits.IRCF0 = 0;
+    // Set the clock, CLOCK_FOSC in Clock Module.h
+    ClockInit();
 
     // Pin IO Setup
-    OpenADC(ADC_FOSC_8 & ADC_RIGHT_JUST & ADC_12_TAD,
-            ADC_CH0 & ADC_INT_OFF & ADC_REF_VDD_VSS,
-            0b00001110);
     TRISAbits.RA0 = 1;
     TRISAbits.RA1 = 0;
-    TRISC = 0xFF;
-    TRISCbits.RC1 = 0;
-    TRISCbits.RC2 = 0;
+    TRISC = 0xFF; // RC1/RC2 are set as outputs by MotorInit()
 
     // Open LCD
-//    XLCDInit();
-//    XLCDClear();
-//    sprintf(line1, "Newhaven");
-//    XLCDL1home();
-//    XLCDPutRamString(line1);
+    XLCDInit();
+    XLCDQueueInit(); // From here on LCD writes return straight away, Timer2 sends them
+    MotorInit(); // CCP1/CCP2 PWM on Timer2, stopped
+    DoorInit(); // IR detector, events and lock, needs the motor and RA1
+    XLCDClear();
+    XLCDBufInit();
+    XLCDGlyphInit();
+    XLCDBufPutRomString(0, 0, "Newhaven");
+    XLCDBufCommit();
+    XLCDScreenShow(&lockScreen); // replaces the splash on the first taskDisplay() commit
 
     // Interrupt setup
-//    RCONbits.IPEN = 1; // Put the interrupts into Priority Mode
-    // Add specific interrupts here...
+    RCONbits.IPEN = 1; // Put the interrupts into Priority Mode
+    // Add specific interrupts here, at their level in Interrupt Module.h
+    ADCSampleInit(); // Timer3 + ADC, high priority, every channel sampled every ADC_SAMPLE_US
+    SchedInit(); // Timer0, low priority, 1 ms tick
+    KeyInit(); // PORTB change on RB4/RB5, high priority
+    SeqInit(); // buttons a, b, c on RB0, RB1, RB2 (pull ups from KeyInit)
+    SerialInit(); // EUSART transmit on RC6, low priority
+    TelemetryInit(); // IR readings out of RC6
+    // Timer2 (LCD queue) is set up as low priority by XLCDQueueInit()
 
-//    INTCONbits.GIEH = 1; // Turn on high priority interrupts
+    INTCONbits.GIEH = 1; // Turn on high priority interrupts
+    INTCONbits.GIEL = 1; // Turn on low priority interrupts
 
+    // Tasks: function, period, phase, priority (0 first)
+    SchedAdd(taskSample, SchedMs(1), 0, 0);
+    SchedAdd(DoorDetect, SchedMs(1), 0, 1);
+    SchedAdd(taskDisplay, SchedMs(100), SchedMs(50), 3);
+    SchedAdd(taskKeycard, SchedMs(20), SchedMs(5), 2);
+    SchedAdd(taskButtons, SchedMs(10), SchedMs(3), 2);
+    SchedAdd(DoorRun, SchedMs(1), 0, 1);
+    SchedAdd(LockTick, SchedMs(LOCK_TICK_MS), SchedMs(7), 2);
+    SchedAdd(taskCommand, SchedMs(20), SchedMs(11), 3);
+    SchedAdd(taskPower, SchedMs(100), SchedMs(13), 3);
+#ifdef TRACE_ENABLE
+    SchedAdd(TraceDrain, SchedMs(10), SchedMs(9), 3); // trace snapshots out of RC6
+#endif
+
+    ProfileReset();
+    IntReset();
+    PowerInit();
     while (1) {
-        SetChanADC(ADC_CH0);
-        ConvertADC();
-        while (BusyADC());
-        ir1 = ReadADC();
-
-        if(ir1>1000){
-            Delay10KTCYx(30);
-            PORTAbits.RA1 = (ir1>1005);
-        }
-//        if (!PORTCbits.RC6) {
-//            PORTCbits.RC1 = 1;
-//            PORTCbits.RC2 = 0;
-//        } else if(!PORTCbits.RC7){
-//            PORTCbits.RC1 = 0;
-//            PORTCbits.RC2 = 1;
-//        }else{
-//            PORTCbits.RC1 = 0;
-//            PORTCbits.RC2 = 0;
-//        }
+        ProfileLoop();
+        ProfileBegin(PROF_TASK);
+        if (SchedRun())
+            ProfileEnd(PROF_TASK); // passes with nothing due aren't counted
+        else
+            idle();
     }
 }
 
 /*****************************************************************
  * Function:        void high_isr(void)
+ * .tmpdata is saved because the handlers are calls into other modules
+ * and C18 keeps their temporaries there; the dispatch itself only does
+ * 16 bit sums, the 32 bit ones are in IntDrain()
  ******************************************************************/
-#pragma interrupt high_isr
+#pragma interrupt high_isr save=section(".tmpdata")
 
 void high_isr(void) {
-    // Add code here for the high priority Interrupt Service Routine (ISR)
+    IntEnter(INT_HIGH);
+    TraceBeginHigh(TR_HIGH);
+    // Sources in Interrupt Module.h order, back to the top after each one
+    for (;;) {
+        // keycard, first so the data pin is read before it moves
+        IntDispatch(INT_HIGH, INT_KEY, INTCONbits.RBIF && INTCONbits.RBIE,
+                KeyISR(IntBegin(INT_HIGH)));
+        // start the next conversion, Timer3 has counted the latency since it overflowed
+        IntDispatch(INT_HIGH, INT_ADC_TIMER, PIR2bits.TMR3IF && PIE2bits.TMR3IE,
+                IntLatency(INT_HIGH, TMR3L, TMR3H); ADCTimerISR());
+        // publish the result
+        IntDispatch(INT_HIGH, INT_ADC, PIR1bits.ADIF && PIE1bits.ADIE, ADCSampleISR());
+        // button a woke PowerNap()
+        IntDispatch(INT_HIGH, INT_WAKE, INTCONbits.INT0IF && INTCONbits.INT0IE, PowerWakeISR());
+        break;
+    }
+    TraceEndHigh(TR_HIGH);
+    IntExit(INT_HIGH);
 }
 
 /******************************************************************
  * Function:        void low_isr(void)
  ********************************************************************/
-#pragma interruptlow low_isr
+#pragma interruptlow low_isr save=section(".tmpdata")
 
 void low_isr(void) {
-    // Add code here for the low priority Interrupt Service Routine (ISR)
+    IntEnter(INT_LOW);
+    TraceBegin(TR_LOW);
+    for (;;) {
+        // scheduler tick and motor speed ramp, Timer0 has counted the latency
+        IntDispatch(INT_LOW, INT_TICK, INTCONbits.TMR0IF && INTCONbits.TMR0IE,
+                IntLatency(INT_LOW, TMR0L, TMR0H); SchedTimerISR(); MotorRampISR());
+        // LCD transmit queue
+        IntDispatch(INT_LOW, INT_LCD, PIR1bits.TMR2IF && PIE1bits.TMR2IE, XLCDQueueISR());
+        // serial transmit ring
+        IntDispatch(INT_LOW, INT_SERIAL, PIR1bits.TXIF && PIE1bits.TXIE, SerialTxISR());
+        break;
+    }
+    TraceEnd(TR_LOW);
+    IntExit(INT_LOW);
 }
 
 #pragma code
@@ -149,3 +227,232 @@ void low_isr(void) {
 void sampleFunction() {
     // Some function that does a specific task
 }
+
+/*****************************************************************
+ * Function:			void taskSample(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Every 1 ms. Takes every IR reading since the last
+ *                  run out of the ADC ring, hands each to the door and
+ *                  sends it out raw, so a late run loses nothing.  In
+ *                  low power a raw reading that could start a detection
+ *                  goes straight back to full rate sampling
+ ******************************************************************/
+void taskSample(void) {
+    unsigned char lastSeq = lastIrSeq;
+    int raw;
+
+    ProfileBegin(PROF_SAMPLE);
+    while (ADCNext(&lastIrSeq, &raw)) {
+        samplesSeen += (unsigned char) (lastIrSeq - lastSeq); // more than 1 if the ring overran
+        lastSeq = lastIrSeq;
+        if (lowPower && raw > IR_EXIT)
+            fullRate();
+        DoorSample(raw, lastIrSeq);
+        TelemetryAdd(raw, lastIrSeq);
+    }
+    ProfileEnd(PROF_SAMPLE);
+}
+
+/*****************************************************************
+ * Function:			void taskDisplay(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Every 100 ms. Fills in the lock state and the IR
+ *                  reading, as a number and a bar, on the lock screen,
+ *                  or shows a profiler section if one has been picked,
+ *                  only the characters that changed go to the LCD
+ ******************************************************************/
+void taskDisplay(void) {
+    ProfileBegin(PROF_DISPLAY);
+    if (profilePage) {
+        ProfileShow(profilePage - 1);
+    } else {
+        XLCDScreenShow(&lockScreen);
+        XLCDScreenRom(&lockScreen, LS_STATE, lockNames[LockState()]);
+        XLCDScreenUDec(&lockScreen, LS_IR, DoorReading());
+        XLCDScreenBar(&lockScreen, LS_BAR, DoorReading(), ADC_MAX);
+    }
+    XLCDBufCommit();
+    ProfileEnd(PROF_DISPLAY);
+}
+
+/*****************************************************************
+ * Function:			void taskKeycard(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Every 20 ms. Shows the last swiped code and
+ *                  whether it is one of keyCombos[] on line 1
+ ******************************************************************/
+void taskKeycard(void) {
+    unsigned char code;
+    char result = KeyRead(&code);
+
+    if (result == KEY_NONE)
+        return;
+    if (!XLCDScreenField(&lockScreen, LS_KEY))
+        return; // profiler page up
+    XLCDFmtHex(code, 2);
+    XLCDFmtRom(result == KEY_VALID ? " OK" : " BAD");
+    XLCDBufCommit();
+}
+
+/*****************************************************************
+ * Function:			void taskButtons(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Every 10 ms. Debounces buttons a, b, c (RB0-RB2,
+ *                  active low, a reading counts once it is the same
+ *                  twice in a row) and feeds each new press to the
+ *                  sequence matcher, a match shows on line 1
+ ******************************************************************/
+void taskButtons(void) {
+    unsigned char now = ~PORTB & 0x07;
+    unsigned char pressed, match, i;
+
+    if (now != buttonsRaw) {
+        buttonsRaw = now; // still bouncing
+        return;
+    }
+    pressed = now & ~buttonsStable;
+    buttonsStable = now;
+    for (i = 0; i < 3; i++) {
+        if (!(pressed & (1 << i)))
+            continue;
+        match = SeqFeed(SEQ_FIRST + i);
+        if (match) {
+            EventPost(EVQ_MAIN, EV_CODE);
+            if (XLCDScreenField(&lockScreen, LS_MATCH)) {
+                XLCDFmtHex(match, 1); // bit n-1 = sequence n
+                XLCDBufCommit();
+            }
+        }
+    }
+}
+
+/*****************************************************************
+ * Function:			void LockBolt(unsigned char move)
+ * Input Variables:	move - LOCK_BOLT_STOP, _OPEN or _CLOSE
+ * Output Return:	none
+ * Overview:			Called by the lock state machine, the bolt is on
+ *                  the motor, forward opens it
+ ******************************************************************/
+void LockBolt(unsigned char move) {
+    if (move == LOCK_BOLT_OPEN)
+        MotorSet(MOTOR_FORWARD, BOLT_SPEED);
+    else if (move == LOCK_BOLT_CLOSE)
+        MotorSet(MOTOR_REVERSE, BOLT_SPEED);
+    else
+        MotorStop();
+}
+
+/*****************************************************************
+ * Function:			void DoorBeamOut(char on)
+ * Input Variables:	on - 1 while the beam is broken
+ * Output Return:	none
+ * Overview:			Called by the door on every new reading, the
+ *                  detector output is RA1
+ ******************************************************************/
+void DoorBeamOut(char on) {
+    PORTAbits.RA1 = on;
+}
+
+/*****************************************************************
+ * Function:			void taskCommand(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Every 20 ms. One key commands from the serial
+ *                  port: p steps the LCD through the profiler sections
+ *                  and back to the lock screen, d dumps the profiler
+ *                  out of the serial port, r resets it and the
+ *                  interrupt counts, i dumps those and starts them
+ *                  again, s reports samples per second and CPU duty
+ *                  since the last s.  The telemetry records are held
+ *                  back until a reply is all in the serial ring
+ ******************************************************************/
+void taskCommand(void) {
+    char busy;
+
+    switch (SerialGet()) {
+        case 'p':
+            if (++profilePage > PROF_SECTIONS)
+                profilePage = 0;
+            break;
+        case 'd':
+            ProfileDump();
+            break;
+        case 'r':
+            ProfileReset();
+            IntReset();
+            break;
+        case 'i':
+            IntDump();
+            break;
+        case 's':
+            reportDue = 1;
+            break;
+    }
+    busy = ProfileDrain();
+    busy |= IntDrain();
+    if (reportDue && PowerReport(samplesSeen)) {
+        reportDue = 0;
+        samplesSeen = 0;
+    }
+    TelemetryHold(busy || reportDue);
+}
+
+/*****************************************************************
+ * Function:			void taskPower(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Every 100 ms (of time awake). Once the door has
+ *                  been locked and still, with nothing near the
+ *                  sensor, for QUIET_MS, sampling drops to one reading
+ *                  per PowerNap(); taskSample() brings it back
+ ******************************************************************/
+void taskPower(void) {
+    if (lowPower)
+        return;
+    if (LockState() != LOCK_LOCKED || DoorBeam() || MotorSpeed() || DoorReading() > IR_EXIT) {
+        quietMs = 0;
+        return;
+    }
+    quietMs += 100;
+    if (quietMs >= QUIET_MS) {
+        ADCSlow(1);
+        lowPower = 1;
+    }
+}
+
+/*****************************************************************
+ * Function:			void fullRate(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Back to Timer3 sampling every ADC_SAMPLE_US
+ ******************************************************************/
+void fullRate(void) {
+    ADCSlow(0);
+    lowPower = 0;
+    quietMs = 0;
+}
+
+/*****************************************************************
+ * Function:			void idle(void)
+ * Input Variables:	none
+ * Output Return:	none
+ * Overview:			Main loop with nothing due. Idles until the next
+ *                  interrupt, or in low power, once taskSample() has
+ *                  had the last reading, sleeps for the next one.
+ *                  Woken by anything else (a keycard, button a) it goes
+ *                  back to full rate
+ ******************************************************************/
+void idle(void) {
+    int raw;
+
+    if (!lowPower || ADCLatest(&raw) != lastIrSeq) {
+        PowerIdle();
+        return;
+    }
+    if (PowerNap() == POWER_WOKEN)
+        fullRate();
+}
@@ -0,0 +1,155 @@
+/*********************************************************************
+ * FileName:        Motor Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * PWM motor drive with ramps, see Motor Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Motor Module.h"
+
+#define MOTOR_CCPCON    0b00001100      // PWM mode, duty LSBs in bits 5:4
+
+// S shaped: easy off the stop and into full speed, quickest in between.
+// 0 to 255 takes 66 steps (0.66 s), 255 to 0 takes 37 (0.37 s).
+rom unsigned char motorAccel[MOTOR_BANDS] = {2, 4, 6, 8, 8, 6, 4, 2};
+rom unsigned char motorDecel[MOTOR_BANDS] = {4, 6, 8, 8, 8, 8, 8, 8};
+
+volatile unsigned char _vMotorTarget = 0; //speed MotorSet() asked for
+volatile char _vMotorTargetDir = MOTOR_FORWARD;
+volatile unsigned char _vMotorSpeed = 0; //speed the PWM is at now
+volatile char _vMotorDir = MOTOR_FORWARD; //only changes while stopped
+unsigned char _vMotorDiv = 0; //scheduler ticks since the last ramp step
+
+/*********************************************************************
+ * Function         :void MotorInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Takes over CCP1, CCP2, RC1 and RC2
+ * Overview         :Both CCPs in PWM mode at 0 duty.  Timer2 is set up
+ *                   exactly as XLCDQueueInit() does it, so the two can
+ *                   be started in either order.
+ * Note             :None
+ ********************************************************************/
+void MotorInit(void) {
+    _vMotorTarget = 0;
+    _vMotorSpeed = 0;
+    _vMotorDir = MOTOR_FORWARD;
+    _vMotorTargetDir = MOTOR_FORWARD;
+    CCPR1L = 0;
+    CCPR2L = 0;
+    CCP1CON = MOTOR_CCPCON;
+    CCP2CON = MOTOR_CCPCON;
+    PR2 = CLOCK_PR2;
+    T2CON = 0b00001100 | CLOCK_T2CKPS; // postscale 1:2 for the LCD queue, timer on
+    TRISCbits.RC1 = 0;
+    TRISCbits.RC2 = 0;
+}
+
+/*********************************************************************
+ * Function         :static void MotorDuty(unsigned char speed)
+ * PreCondition     :None
+ * Input            :speed - 0 to 255
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :speed / 256 of the PWM period on the CCP for the
+ *                   current direction.  The 10 bit duty is
+ *                   4 * (PR2 + 1) * speed / 256, so one 16 bit product
+ *                   gives both the 8 MSBs (CCPRxL) and the 2 LSBs.
+ * Note             :The other CCP was left at 0 when the motor stopped
+ ********************************************************************/
+static void MotorDuty(unsigned char speed) {
+    unsigned int p = (unsigned int) speed * (unsigned int) (CLOCK_PR2 + 1);
+
+    if (_vMotorDir == MOTOR_FORWARD) {
+        CCPR1L = p >> 8;
+        CCP1CON = MOTOR_CCPCON | ((unsigned char) (p >> 2) & 0x30);
+    } else {
+        CCPR2L = p >> 8;
+        CCP2CON = MOTOR_CCPCON | ((unsigned char) (p >> 2) & 0x30);
+    }
+}
+
+/*********************************************************************
+ * Function         :void MotorRampISR(void)
+ * PreCondition     :MotorInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Every MOTOR_RAMP_MS ticks moves the speed one table
+ *                   step towards the target, without overshooting it.
+ *                   A change of direction ramps down to 0, swaps over
+ *                   and ramps back up.
+ * Note             :Call from low_isr after SchedTimerISR()
+ ********************************************************************/
+void MotorRampISR(void) {
+    unsigned char speed, target, step;
+
+    if (++_vMotorDiv < MOTOR_RAMP_MS)
+        return;
+    _vMotorDiv = 0;
+
+    speed = _vMotorSpeed;
+    target = _vMotorTarget;
+    if (_vMotorTargetDir != _vMotorDir)
+        target = 0; // stop before turning round
+    if (speed < target) {
+        step = motorAccel[speed >> 5];
+        speed = (unsigned char) (target - speed) > step ? speed + step : target;
+    } else if (speed > target) {
+        step = motorDecel[speed >> 5];
+        speed = (unsigned char) (speed - target) > step ? speed - step : target;
+    } else {
+        if (speed == 0)
+            _vMotorDir = _vMotorTargetDir; // stopped, safe to swap
+        return;
+    }
+    _vMotorSpeed = speed;
+    MotorDuty(speed);
+}
+
+/*********************************************************************
+ * Function         :void MotorSet(char direction, unsigned char speed)
+ * PreCondition     :MotorInit() has been called
+ * Input            :direction - MOTOR_FORWARD or MOTOR_REVERSE
+ *                   speed - 0 (stop) to 255 (full)
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Sets where the ramp is heading
+ * Note             :The ramp can see the new direction with the old
+ *                   speed for one step, which only costs that step.
+ ********************************************************************/
+void MotorSet(char direction, unsigned char speed) {
+    _vMotorTargetDir = direction;
+    _vMotorTarget = speed;
+}
+
+/*********************************************************************
+ * Function         :unsigned char MotorSpeed(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :Speed the PWM is at now, 0 to 255
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+unsigned char MotorSpeed(void) {
+    return _vMotorSpeed;
+}
+
+/*********************************************************************
+ * Function         :char MotorDirection(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :MOTOR_FORWARD or MOTOR_REVERSE
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+char MotorDirection(void) {
+    return _vMotorDir;
+}
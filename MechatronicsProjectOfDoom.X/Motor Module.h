@@ -0,0 +1,59 @@
+/*********************************************************************
+ * FileName:        Motor Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * PWM motor drive through CCP1/CCP2.  The main loop only says which way
+ * and how fast with MotorSet(), the scheduler tick walks the actual
+ * speed towards that along the ROM ramp tables in Motor Module.c, so
+ * the mechanism is never started or stopped with a jolt.  Reversing
+ * ramps down to a stop first.
+ *
+ *	Wiring (same pins the old code switched full on/full off):
+ *		RC2 (CCP1)	- H bridge input A, PWM while going forward
+ *		RC1 (CCP2)	- H bridge input B, PWM while in reverse
+ *   The idle input is held low, so the bridge brakes when the duty is 0.
+ *
+ * The PWM runs off Timer2 at CLOCK_T2_US (10 kHz, out of hearing),
+ * which the LCD queue shares.  Duty resolution is 4 * (CLOCK_PR2 + 1)
+ * steps: 400 at 4 MHz, 800 at 32 MHz.
+ *
+ * The ramp is stepped from the 1 ms scheduler tick, in low_isr:
+ *   if (INTCONbits.TMR0IF && INTCONbits.TMR0IE) {
+ *       SchedTimerISR();
+ *       MotorRampISR();
+ *   }
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __MOTOR_MODULE_H
+#define __MOTOR_MODULE_H
+#if defined(__18CXX)
+#include <p18cxxx.h>
+#else
+#include "motorhost.h"  // Host (gcc) build against tools/motorsim
+#endif
+#include "Clock Module.h"
+
+#define MOTOR_FORWARD   0
+#define MOTOR_REVERSE   1
+#define MOTOR_RAMP_MS   10      // Scheduler ticks between ramp steps
+#define MOTOR_BANDS     8       // Entries in the ramp tables, one per 32 speed counts
+
+void MotorInit(void); // PWM on RC1/RC2 stopped, starts Timer2 if XLCDQueueInit() hasn't
+void MotorRampISR(void); // Call on every scheduler tick (Timer0, low_isr)
+
+// Target direction and speed, 0 (stopped) to 255 (full).  Returns at once, the
+// ramp gets there in up to about a second.
+void MotorSet(char direction, unsigned char speed);
+#define MotorStop()     MotorSet(MotorDirection(), 0)
+unsigned char MotorSpeed(void); // Speed the motor is being driven at now
+char MotorDirection(void); // ... and which way
+
+// Ramp steps, speed counts per MOTOR_RAMP_MS by speed / 32
+extern rom unsigned char motorAccel[MOTOR_BANDS];
+extern rom unsigned char motorDecel[MOTOR_BANDS];
+
+#endif
@@ -0,0 +1,201 @@
+/*********************************************************************
+ * FileName:        Power Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Idle and sleep, see Power Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include <p18f4520.h>
+#include "Power Module.h"
+#include "Clock Module.h"
+#include "Scheduler Module.h"
+#include "ADC Module.h"
+#include "Serial Module.h"
+#include "LCD Format.h"
+
+#define POWER_LINE      58      // longest report, without the CR LF
+
+unsigned long PowerActiveUs = 0;
+unsigned long PowerIdleUs = 0;
+unsigned long PowerSleepMs = 0;
+unsigned int PowerNaps = 0;
+
+unsigned int _vPowerStamp; //ClockStamp() when the CPU last woke
+unsigned int _vPowerTick; //  and SchedNow()
+
+/*********************************************************************
+ * Function         :void PowerInit(void)
+ * PreCondition     :ClockInit() and SchedInit() have been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Counts from now
+ * Note             :None
+ ********************************************************************/
+void PowerInit(void) {
+    PowerActiveUs = 0;
+    PowerIdleUs = 0;
+    PowerSleepMs = 0;
+    PowerNaps = 0;
+    _vPowerStamp = ClockStamp();
+    _vPowerTick = SchedNow();
+}
+
+/*********************************************************************
+ * Function         :static unsigned int PowerAwake(void)
+ * PreCondition     :PowerInit() has been called
+ * Input            :None
+ * Output           :ClockStamp() now
+ * Side Effects     :None
+ * Overview         :Adds the time since the CPU last woke to
+ *                   PowerActiveUs.  Past 64 ticks Timer1 may have
+ *                   wrapped, the scheduler ticks are used instead.
+ * Note             :None
+ ********************************************************************/
+static unsigned int PowerAwake(void) {
+    unsigned int now = ClockStamp();
+    unsigned int ticks = SchedNow() - _vPowerTick;
+
+    if (ticks >= 64)
+        PowerActiveUs += (unsigned long) ticks * SCHED_TICK_US;
+    else
+        PowerActiveUs += now - _vPowerStamp;
+    return now;
+}
+
+/*********************************************************************
+ * Function         :void PowerIdle(void)
+ * PreCondition     :PowerInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Idle mode until an interrupt.  The interrupt that
+ *                   ends it runs before this carries on, so its time
+ *                   is counted as idle, a few tens of us a wake.
+ * Note             :An interrupt that comes in just before the Sleep()
+ *                   has already been handled, so this waits for the
+ *                   next one, a scheduler tick at the latest
+ ********************************************************************/
+void PowerIdle(void) {
+    unsigned int now = PowerAwake();
+
+    OSCCONbits.IDLEN = 1;
+    Sleep();
+    _vPowerStamp = ClockStamp();
+    _vPowerTick = SchedNow();
+    PowerIdleUs += _vPowerStamp - now;
+}
+
+/*********************************************************************
+ * Function         :unsigned char PowerNap(void)
+ * PreCondition     :ADCSlow(1), the motor stopped
+ * Input            :None
+ * Output           :POWER_SLEPT, POWER_BUSY or POWER_WOKEN
+ * Side Effects     :An ADC scan, unless POWER_WOKEN
+ * Overview         :Sleeps until the watchdog times out, starts a
+ *                   scan and sleeps again until the ADC interrupt
+ *                   wakes it with the last result.  RCONbits.TO is only
+ *                   cleared by a time-out, so if it is still set
+ *                   something else woke it.  Only the watchdog periods
+ *                   count as sleep, the rest (oscillator start-up, the
+ *                   conversion) is counted as awake.
+ * Note             :The watchdog is only on while this is asleep, with
+ *                   it on awake it would reset the chip
+ ********************************************************************/
+unsigned char PowerNap(void) {
+    unsigned char woken;
+    unsigned int now;
+
+    if (PIE1bits.TXIE || PIE1bits.TMR2IE || ADCBusy()) {
+        PowerIdle(); // serial or LCD still sending, their interrupts need the clock
+        return POWER_BUSY;
+    }
+    now = PowerAwake();
+    INTCON2bits.INTEDG0 = 0; // falling, the button pulls RB0 low
+    INTCONbits.INT0IF = 0;
+    INTCONbits.INT0IE = 1;
+    OSCCONbits.IDLEN = 0;
+    ClrWdt();
+    WDTCONbits.SWDTEN = 1;
+    Sleep();
+    woken = RCONbits.TO;
+    if (!woken) {
+        PowerSleepMs += POWER_WDT_MS;
+        PowerNaps++;
+        ClrWdt();
+        ADCStart();
+        do {
+            Sleep(); // each conversion of each channel's burst wakes it
+        } while (ADCBusy());
+    }
+    WDTCONbits.SWDTEN = 0;
+    INTCONbits.INT0IE = 0;
+    _vPowerStamp = now; // Timer1 and the ticks stood still, from now on is time awake
+    _vPowerTick = SchedNow();
+    return woken ? POWER_WOKEN : POWER_SLEPT;
+}
+
+/*********************************************************************
+ * Function         :void PowerWakeISR(void)
+ * PreCondition     :INTCONbits.INT0IF is set
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Clears INTCONbits.INT0IF and INT0IE
+ * Overview         :Nothing to do but let PowerNap() see it was woken,
+ *                   the button itself is read by the buttons task
+ * Note             :Call from high_isr
+ ********************************************************************/
+void PowerWakeISR(void) {
+    INTCONbits.INT0IE = 0;
+    INTCONbits.INT0IF = 0;
+}
+
+/*********************************************************************
+ * Function         :char PowerReport(unsigned long samples)
+ * PreCondition     :SerialInit() has been called
+ * Input            :samples - IR readings taken since the last report
+ * Output           :1 if sent, 0 if the serial ring had no room
+ * Side Effects     :Uses the LCD Format buffer output
+ * Overview         :One line, rates and percentages of the total time
+ *                   since the last report, which starts the counts
+ *                   again.  Cpu and idle are Timer1 us per ms, sleep
+ *                   is watchdog ms, all three per mille.
+ * Note             :Main loop only
+ ********************************************************************/
+char PowerReport(unsigned long samples) {
+    char line[POWER_LINE + 1];
+    unsigned long ms;
+    unsigned char i, n;
+
+    PowerAwake();
+    _vPowerStamp = ClockStamp();
+    _vPowerTick = SchedNow();
+    ms = (PowerActiveUs + PowerIdleUs) / 1000 + PowerSleepMs;
+    if (!ms)
+        ms = 1;
+
+    XLCDFmtToBuf(line, sizeof line);
+    XLCDFmtUDec((unsigned int) (samples * 1000 / ms), 0, ' ');
+    XLCDFmtRom(" samples/s cpu ");
+    XLCDFmtFixed((int) (PowerActiveUs / ms), 1, 0, ' '); // us per ms = per mille
+    XLCDFmtRom("% idle ");
+    XLCDFmtFixed((int) (PowerIdleUs / ms), 1, 0, ' ');
+    XLCDFmtRom("% sleep ");
+    XLCDFmtFixed((int) (PowerSleepMs * 1000 / ms), 1, 0, ' ');
+    XLCDFmtRom("% in ");
+    XLCDFmtUDec((unsigned int) (ms / 1000), 0, ' ');
+    XLCDFmtRom(" s");
+    n = XLCDFmtCount();
+    if (SerialRoom() < n + 2)
+        return 0;
+    for (i = 0; i < n; i++)
+        SerialPut(line[i]);
+    SerialPut('\r');
+    SerialPut('\n');
+    PowerInit();
+    return 1;
+}
@@ -0,0 +1,64 @@
+/*********************************************************************
+ * FileName:        Power Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Idle and sleep for the main loop, and what they save.
+ *
+ * PowerIdle() stops the CPU (Idle mode, IDLEN = 1) until the next
+ * interrupt, the timers and peripherals keep running, so it goes in
+ * the main loop whenever SchedRun() has nothing to do.  The scheduler
+ * tick wakes it at least every SCHED_TICK_US.
+ *
+ * PowerNap() is for when nothing is going on: full Sleep, oscillator
+ * and all, for one watchdog period, then one scan of the ADC channels
+ * on the ADC's RC clock, still asleep, and back.  About POWER_WDT_MS between IR
+ * readings, with the CPU awake only long enough to run the tasks that
+ * are due.  The ADC has to be in ADCSlow(1).  Every timer stops while
+ * asleep, so scheduler time and Timer1 only count the time awake; the
+ * motor PWM freezes and the LCD and serial port stop, PowerNap() only
+ * sleeps when neither of those has anything left to send.  A keycard
+ * edge (PORTB change) or button a (INT0 on RB0, only enabled while
+ * asleep) wakes it early; nothing else typed or pressed is seen.
+ *
+ * In high_isr:
+ *   if (INTCONbits.INT0IF && INTCONbits.INT0IE) PowerWakeISR();
+ *
+ * The watchdog has to be off in the config bits (WDT = OFF, PowerNap()
+ * turns it on in software) with WDTPS = 16, 4 ms x 16 = POWER_WDT_MS.
+ *
+ * Where the time went, since PowerReport() or PowerInit():
+ *   PowerActiveUs  CPU running (Timer1)
+ *   PowerIdleUs    in PowerIdle() (Timer1)
+ *   PowerSleepMs   in PowerNap(), watchdog periods x POWER_WDT_MS (the
+ *                  watchdog runs off INTRC, +-15% or so)
+ * PowerReport() turns them into samples per second and CPU duty:
+ *
+ *   15 samples/s cpu 2.1% idle 1.3% sleep 96.6% in 61 s
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __POWER_MODULE_H
+#define __POWER_MODULE_H
+
+#define POWER_WDT_MS    64      // Watchdog period, #pragma config WDTPS = 16
+
+// PowerNap() results
+#define POWER_SLEPT     0       // a whole watchdog period and a scan
+#define POWER_BUSY      1       // LCD, serial or ADC still going, idled instead
+#define POWER_WOKEN     2       // something other than the watchdog woke it
+
+void PowerInit(void); // Starts the counts, just before the main loop
+void PowerIdle(void); // CPU off until the next interrupt
+unsigned char PowerNap(void); // Sleep, then one ADC scan, returns POWER_...
+void PowerWakeISR(void); // Button a woke PowerNap()
+char PowerReport(unsigned long samples); // One line out of the serial port and starts again, 0 if no room
+
+extern unsigned long PowerActiveUs;
+extern unsigned long PowerIdleUs;
+extern unsigned long PowerSleepMs;
+extern unsigned int PowerNaps; // PowerNap() calls that slept
+
+#endif
@@ -0,0 +1,333 @@
+/*********************************************************************
+ * FileName:        Profile Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Main loop profiler, see Profile Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Profile Module.h"
+#include "Clock Module.h"
+#include "Scheduler Module.h"
+#include "Serial Module.h"
+#include "LCD Buffer.h"
+#include "LCD Format.h"
+#include "LCD Glyph.h"
+#include "LCD Screen.h"
+
+#ifdef PROFILE_ENABLE
+
+#if PROF_SECTIONS > 8
+#error "PROF_SECTIONS is more than _vProfOpen has bits for"
+#endif
+
+#define PROF_LONG_TICKS 64      // Timer1 wraps at 65.536 ms, anything this long is 65535
+#define PROF_HALVE      0x8000  // count that halves the stats
+#define PROF_LINE       48      // longest dump line, without the CR LF
+
+unsigned int _vProfMin[PROF_SECTIONS];
+unsigned int _vProfMax[PROF_SECTIONS];
+unsigned int _vProfCount[PROF_SECTIONS];
+unsigned long _vProfTotal[PROF_SECTIONS]; //us, at most PROF_HALVE * 65535
+unsigned int _vProfHist[PROF_SECTIONS][PROF_BUCKETS];
+unsigned int _vProfStart[PROF_SECTIONS]; //ClockStamp() at ProfileBegin()
+unsigned int _vProfTick[PROF_SECTIONS]; //  and SchedNow()
+unsigned char _vProfOpen = 0; //bit per section, ProfileBegin() without an end yet
+
+unsigned char _vProfDumpSec = PROF_SECTIONS; //section being dumped, PROF_SECTIONS when idle
+unsigned char _vProfDumpLine; //0 the summary, then bucket + 1
+
+rom char *rom _vProfNames[PROF_SECTIONS] = {"loop", "task", "smpl", "disp"};
+
+// ProfileShow() screen, "task    61  5210" over the histogram
+#define PROF_F_NAME     0
+#define PROF_F_MEAN     1
+#define PROF_F_MAX      2
+#define PROF_F_HIST     3
+rom XLCDField _vProfFields[4] = {{0, 0, 4}, {0, 4, 6}, {0, 10, 6}, {1, 0, PROF_BUCKETS - 1}};
+rom XLCDScreen _vProfScreen = {"                " "                ", _vProfFields, 4};
+
+// Significant bits in 0 - 15
+rom unsigned char _vProfBits[16] = {0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+
+// Histogram columns 1 - 7 dots high, 8 is XLCD_FULL_BLOCK
+rom unsigned char _vProfCol1[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F};
+rom unsigned char _vProfCol2[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F};
+rom unsigned char _vProfCol3[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F};
+rom unsigned char _vProfCol4[8] = {0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F};
+rom unsigned char _vProfCol5[8] = {0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F};
+rom unsigned char _vProfCol6[8] = {0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F};
+rom unsigned char _vProfCol7[8] = {0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F};
+rom unsigned char *rom _vProfCols[7] = {_vProfCol1, _vProfCol2, _vProfCol3, _vProfCol4,
+    _vProfCol5, _vProfCol6, _vProfCol7};
+
+/*********************************************************************
+ * Function         :void ProfileReset(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Stops a dump that is going out
+ * Overview         :Every section back to no samples
+ * Note             :None
+ ********************************************************************/
+void ProfileReset(void) {
+    unsigned char s, b;
+
+    for (s = 0; s < PROF_SECTIONS; s++) {
+        _vProfMin[s] = 0xFFFF;
+        _vProfMax[s] = 0;
+        _vProfCount[s] = 0;
+        _vProfTotal[s] = 0;
+        for (b = 0; b < PROF_BUCKETS; b++)
+            _vProfHist[s][b] = 0;
+    }
+    _vProfOpen = 0;
+    _vProfDumpSec = PROF_SECTIONS;
+}
+
+/*********************************************************************
+ * Function         :static unsigned char ProfileBucket(unsigned int us)
+ * PreCondition     :None
+ * Input            :us - time
+ * Output           :Significant bits in us, 0 - 16
+ * Side Effects     :None
+ * Overview         :Byte, then nibble, then a table, no shift loop
+ * Note             :None
+ ********************************************************************/
+static unsigned char ProfileBucket(unsigned int us) {
+    unsigned char b = us >> 8;
+    unsigned char n = 8;
+
+    if (!b) {
+        b = us;
+        n = 0;
+    }
+    if (b & 0xF0) {
+        b >>= 4;
+        n += 4;
+    }
+    return n + _vProfBits[b];
+}
+
+/*********************************************************************
+ * Function         :static void ProfileAdd(unsigned char s, unsigned int us)
+ * PreCondition     :None
+ * Input            :s - section
+ *                   us - one time for it
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Halves the count, total and buckets first if the
+ *                   count is at PROF_HALVE, which keeps every bucket
+ *                   and the total from overflowing.
+ * Note             :None
+ ********************************************************************/
+static void ProfileAdd(unsigned char s, unsigned int us) {
+    unsigned int *h = _vProfHist[s];
+    unsigned char b;
+
+    if (us < _vProfMin[s])
+        _vProfMin[s] = us;
+    if (us > _vProfMax[s])
+        _vProfMax[s] = us;
+    if (_vProfCount[s] >= PROF_HALVE) {
+        _vProfCount[s] >>= 1;
+        _vProfTotal[s] >>= 1;
+        for (b = 0; b < PROF_BUCKETS; b++)
+            h[b] >>= 1;
+    }
+    _vProfCount[s]++;
+    _vProfTotal[s] += us;
+    h[ProfileBucket(us)]++;
+}
+
+/*********************************************************************
+ * Function         :void ProfileBegin(unsigned char section)
+ * PreCondition     :ClockInit() and SchedInit() have been called
+ * Input            :section - PROF_...
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Notes the time, a second begin starts it again
+ * Note             :Main loop only
+ ********************************************************************/
+void ProfileBegin(unsigned char section) {
+    _vProfStart[section] = ClockStamp();
+    _vProfTick[section] = SchedNow();
+    _vProfOpen |= 1 << section;
+}
+
+/*********************************************************************
+ * Function         :void ProfileEnd(unsigned char section)
+ * PreCondition     :ClockInit() and SchedInit() have been called
+ * Input            :section - PROF_...
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Adds the time since ProfileBegin(section).  The
+ *                   scheduler tick tells apart times Timer1 has
+ *                   wrapped on, those count as 65535.  An end with no
+ *                   begin does nothing.
+ * Note             :Main loop only
+ ********************************************************************/
+void ProfileEnd(unsigned char section) {
+    unsigned int now = ClockStamp();
+    unsigned char bit = 1 << section;
+
+    if (!(_vProfOpen & bit))
+        return;
+    _vProfOpen &= ~bit;
+    if (SchedNow() - _vProfTick[section] >= PROF_LONG_TICKS)
+        ProfileAdd(section, 0xFFFF);
+    else
+        ProfileAdd(section, now - _vProfStart[section]);
+}
+
+/*********************************************************************
+ * Function         :void ProfileLoop(void)
+ * PreCondition     :ClockInit() and SchedInit() have been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Ends the last pass and begins this one, so
+ *                   PROF_LOOP is the time from one call to the next.
+ * Note             :Once per pass of the main loop
+ ********************************************************************/
+void ProfileLoop(void) {
+    ProfileEnd(PROF_LOOP);
+    ProfileBegin(PROF_LOOP);
+}
+
+/*********************************************************************
+ * Function         :static unsigned int ProfileMean(unsigned char s)
+ * PreCondition     :None
+ * Input            :s - section
+ * Output           :Mean time, 0 with no samples
+ * Side Effects     :None
+ * Overview         :32 by 16 bit divide, tasks only
+ * Note             :None
+ ********************************************************************/
+static unsigned int ProfileMean(unsigned char s) {
+    if (!_vProfCount[s])
+        return 0;
+    return (unsigned int) (_vProfTotal[s] / _vProfCount[s]);
+}
+
+/*********************************************************************
+ * Function         :void ProfileShow(unsigned char section)
+ * PreCondition     :XLCDBufInit() and XLCDGlyphInit() have been called
+ * Input            :section - PROF_...
+ * Output           :None
+ * Side Effects     :Uses up to 7 glyphs, puts its own screen up
+ * Overview         :Line 1 is the name then the mean and max in us,
+ *                   right aligned, all 16 cells.  Line 2 has a column
+ *                   per bucket from 1 us up, scaled so the biggest is
+ *                   8 dots; a bucket with anything in it gets a dot.
+ * Note             :None
+ ********************************************************************/
+void ProfileShow(unsigned char section) {
+    unsigned int *h = _vProfHist[section];
+    unsigned int most = 0;
+    unsigned char b, level;
+    char cell;
+
+    XLCDScreenShow(&_vProfScreen);
+    XLCDScreenRom(&_vProfScreen, PROF_F_NAME, _vProfNames[section]);
+    XLCDScreenUDec(&_vProfScreen, PROF_F_MEAN, ProfileMean(section));
+    XLCDScreenUDec(&_vProfScreen, PROF_F_MAX, _vProfMax[section]);
+
+    for (b = 1; b < PROF_BUCKETS; b++)
+        if (h[b] > most)
+            most = h[b];
+    XLCDScreenField(&_vProfScreen, PROF_F_HIST);
+    for (b = 1; b < PROF_BUCKETS; b++) {
+        level = 0;
+        if (h[b])
+            level = (unsigned char) (((unsigned long) h[b] * 8 + most - 1) / most);
+        if (level == 0)
+            cell = ' ';
+        else if (level == 8)
+            cell = XLCD_FULL_BLOCK;
+        else
+            cell = XLCDGlyph(_vProfCols[level - 1]);
+        XLCDFmtChar(cell);
+    }
+}
+
+/*********************************************************************
+ * Function         :void ProfileDump(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Starts from the first section, a dump already
+ *                   going out starts over
+ * Note             :None
+ ********************************************************************/
+void ProfileDump(void) {
+    _vProfDumpSec = 0;
+    _vProfDumpLine = 0;
+}
+
+/*********************************************************************
+ * Function         :char ProfileDrain(void)
+ * PreCondition     :SerialInit() has been called
+ * Input            :None
+ * Output           :1 while there is more of the dump to send
+ * Side Effects     :Uses the LCD Format buffer output
+ * Overview         :Formats the next line and sends it if it fits in
+ *                   the serial ring, whole lines only so they don't
+ *                   get cut up by other records on the port.  Empty
+ *                   buckets are skipped.  The stats go on changing
+ *                   while the dump goes out, a line is as of when it
+ *                   was sent.
+ * Note             :Main loop only
+ ********************************************************************/
+char ProfileDrain(void) {
+    char line[PROF_LINE + 1];
+    unsigned char s, b, i, n;
+
+    while (_vProfDumpSec < PROF_SECTIONS) {
+        s = _vProfDumpSec;
+        XLCDFmtToBuf(line, sizeof line);
+        if (_vProfDumpLine == 0) {
+            XLCDFmtRom(_vProfNames[s]);
+            XLCDFmtRom(" n ");
+            XLCDFmtUDec(_vProfCount[s], 0, ' ');
+            if (_vProfCount[s]) {
+                XLCDFmtRom(" min ");
+                XLCDFmtUDec(_vProfMin[s], 0, ' ');
+                XLCDFmtRom(" mean ");
+                XLCDFmtUDec(ProfileMean(s), 0, ' ');
+                XLCDFmtRom(" max ");
+                XLCDFmtUDec(_vProfMax[s], 0, ' ');
+                XLCDFmtRom(" us");
+            }
+        } else {
+            b = _vProfDumpLine - 1;
+            if (_vProfHist[s][b]) {
+                XLCDFmtRom("  >= ");
+                XLCDFmtUDec(b ? 1U << (b - 1) : 0, 5, ' ');
+                XLCDFmtRom(" us ");
+                XLCDFmtUDec(_vProfHist[s][b], 0, ' ');
+            }
+        }
+
+        n = XLCDFmtCount();
+        if (n) {
+            if (SerialRoom() < n + 2)
+                return 1; // try again next time
+            for (i = 0; i < n; i++)
+                SerialPut(line[i]);
+            SerialPut('\r');
+            SerialPut('\n');
+        }
+        if (++_vProfDumpLine > PROF_BUCKETS) {
+            _vProfDumpLine = 0;
+            _vProfDumpSec++;
+        }
+    }
+    return 0;
+}
+
+#endif
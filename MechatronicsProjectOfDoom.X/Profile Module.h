@@ -0,0 +1,64 @@
+/*********************************************************************
+ * FileName:        Profile Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Main loop profiler.  ProfileLoop() at the top of the main loop times
+ * each pass from the last one, ProfileBegin(section)/ProfileEnd(section)
+ * time a stretch of main loop code.  Times come from Timer1 (1 us, see
+ * ClockStamp()); anything 64 ms or longer is counted as 65535 us.
+ *
+ * Each section keeps min, max, mean and a histogram in powers of 2:
+ * bucket 0 is 0 us, bucket b is 2^(b-1) up to 2^b - 1 us, 17 buckets.
+ * When the count gets to 32768 the count, the total and every bucket
+ * are halved, so the mean and histogram follow the last 16k to 32k
+ * times and nothing overflows; min and max hold until ProfileReset().
+ *
+ * ProfileShow() draws one section on the LCD: name, mean and max us on
+ * line 1, the histogram from 1 us to 65 ms as 16 columns of bars on
+ * line 2.  ProfileDump() sends every section out of the serial port as
+ * text, a line at a time from ProfileDrain():
+ *
+ *   loop n 32768 min 14 mean 61 max 5210 us
+ *     >=     8 us 11071
+ *     >=    16 us 20313
+ *
+ * Everything is main loop only, none of it can go in an interrupt.
+ * Without PROFILE_ENABLE all of it compiles to nothing.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __PROFILE_MODULE_H
+#define __PROFILE_MODULE_H
+
+#define PROFILE_ENABLE          // Comment out to compile the profiler out
+#define PROF_BUCKETS    17
+
+// Sections, names in Profile Module.c
+#define PROF_LOOP       0       // one pass of the main loop, from ProfileLoop()
+#define PROF_TASK       1       // a SchedRun() that ran a task
+#define PROF_SAMPLE     2       // taskSample(), IR reading and telemetry
+#define PROF_DISPLAY    3       // taskDisplay(), formatting and the LCD commit
+#define PROF_SECTIONS   4       // up to 8
+
+#ifdef PROFILE_ENABLE
+void ProfileReset(void); // Clears every section, call once before the main loop
+void ProfileLoop(void); // Top of the main loop
+void ProfileBegin(unsigned char section);
+void ProfileEnd(unsigned char section); // Counts the time since ProfileBegin(section)
+void ProfileShow(unsigned char section); // Draws it into the LCD Buffer, XLCDBufCommit() to show
+void ProfileDump(void); // Starts sending every section out of the serial port
+char ProfileDrain(void); // Task, every 20 ms or so: sends the dump as the serial ring has room, 1 until it is all out
+#else
+#define ProfileReset()
+#define ProfileLoop()
+#define ProfileBegin(section)
+#define ProfileEnd(section)
+#define ProfileShow(section)
+#define ProfileDump()
+#define ProfileDrain() 0
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+/*********************************************************************
+ * FileName:        Scheduler Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Cooperative scheduler, see Scheduler Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifdef __18CXX
+#include <p18cxxx.h>
+#endif
+#include "Scheduler Module.h"
+#include "Trace Module.h"
+
+typedef struct {
+    void (*task)(void);
+    unsigned int period;
+    unsigned int due; //tick the next run is due on
+    unsigned int overruns;
+    unsigned char priority;
+} SchedTask_t;
+
+SchedTask_t _vSchedTasks[SCHED_MAX_TASKS]; //in the order they were added, index = id
+unsigned char _vSchedOrder[SCHED_MAX_TASKS]; //ids sorted by priority
+unsigned char _vSchedCount;
+volatile unsigned int _vSchedTicks;
+
+/*********************************************************************
+ * Function         :void SchedInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Takes over Timer0 and its interrupt
+ * Overview         :Timer0 in 16 bit mode, no prescaler, low priority
+ * Note             :Ticks start once GIEL is set
+ ********************************************************************/
+void SchedInit(void) {
+    _vSchedCount = 0;
+    _vSchedTicks = 0;
+#ifdef __18CXX
+    TMR0H = SCHED_TMR0_RELOAD >> 8;
+    TMR0L = SCHED_TMR0_RELOAD & 0xFF;
+    T0CON = 0b10001000; // on, 16 bit, internal clock, no prescaler
+    INTCON2bits.TMR0IP = 0; // low priority, see Interrupt Module.h
+    INTCONbits.TMR0IF = 0;
+    INTCONbits.TMR0IE = 1;
+#endif
+}
+
+#ifdef __18CXX
+/*********************************************************************
+ * Function         :void SchedTimerISR(void)
+ * PreCondition     :INTCONbits.TMR0IF is set
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Clears INTCONbits.TMR0IF
+ * Overview         :Adds the reload to whatever Timer0 has counted since
+ *                   the overflow, so the time the interrupt took to get
+ *                   here doesn't stretch the tick.  High priority
+ *                   interrupts are held off from the read to the write,
+ *                   Timer0 counts on through one and it would be lost,
+ *                   and over the tick count's two bytes, so KeyISR()
+ *                   never sees it half moved on.
+ * Note             :Call from low_isr, GIEH is set again on the way out
+ ********************************************************************/
+void SchedTimerISR(void) {
+    unsigned int t;
+
+    INTCONbits.GIEH = 0;
+    t = TMR0L; // reading TMR0L latches TMR0H
+    t |= (unsigned int) TMR0H << 8;
+    t += SCHED_TMR0_RELOAD;
+    TMR0H = t >> 8; // latched, written together with TMR0L
+    TMR0L = t & 0xFF;
+    _vSchedTicks++; // SchedTick(), inline to keep it in here
+    INTCONbits.GIEH = 1;
+    INTCONbits.TMR0IF = 0;
+}
+#endif
+
+/*********************************************************************
+ * Function         :void SchedTick(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :One tick has gone by
+ * Note             :Host builds; SchedTimerISR() does the same on the PIC
+ ********************************************************************/
+void SchedTick(void) {
+    _vSchedTicks++;
+}
+
+/*********************************************************************
+ * Function         :unsigned int SchedNow(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :Ticks since SchedInit()
+ * Side Effects     :None
+ * Overview         :The count is two bytes and the tick can land between
+ *                   them, so read it until two reads agree.  In high_isr
+ *                   the loop goes round once: the tick only moves with
+ *                   GIEH off, so it is never half done there.
+ * Note             :None
+ ********************************************************************/
+unsigned int SchedNow(void) {
+    unsigned int now;
+
+    do {
+        now = _vSchedTicks;
+    } while (now != _vSchedTicks);
+    return now;
+}
+
+/*********************************************************************
+ * Function         :unsigned char SchedAdd(void (*task)(void), unsigned int period,
+ *                          unsigned int phase, unsigned char priority)
+ * PreCondition     :SchedInit() has been called
+ * Input            :task - function to run
+ *                   period - ticks between runs, at least 1
+ *                   phase - ticks from now until the first run
+ *                   priority - 0 runs first, equal priorities run in
+ *                   the order they were added
+ * Output           :Task id for SchedOverruns(), or SCHED_FULL
+ * Side Effects     :None
+ * Overview         :Inserts the id in the priority list so SchedRun()
+ *                   only has to take the first one that's due.
+ * Note             :Add tasks before the main loop starts
+ ********************************************************************/
+unsigned char SchedAdd(void (*task)(void), unsigned int period, unsigned int phase,
+        unsigned char priority) {
+    SchedTask_t *t;
+    unsigned char id = _vSchedCount;
+    unsigned char i;
+
+    if (id == SCHED_MAX_TASKS)
+        return SCHED_FULL;
+    t = &_vSchedTasks[id];
+    t->task = task;
+    t->period = period ? period : 1;
+    t->due = SchedNow() + phase;
+    t->overruns = 0;
+    t->priority = priority;
+    for (i = id; i > 0 && _vSchedTasks[_vSchedOrder[i - 1]].priority > priority; i--)
+        _vSchedOrder[i] = _vSchedOrder[i - 1];
+    _vSchedOrder[i] = id;
+    _vSchedCount++;
+    return id;
+}
+
+/*********************************************************************
+ * Function         :char SchedRun(void)
+ * PreCondition     :SchedInit() has been called
+ * Input            :None
+ * Output           :1 if a task ran, 0 if nothing was due
+ * Side Effects     :Runs a task
+ * Overview         :Takes the first due task in priority order.  Only
+ *                   one runs per call, so a higher priority task that
+ *                   falls due meanwhile goes next.
+ * Note             :Time differences are taken as 16 bit signed, so a
+ *                   task can't be more than 32767 ticks out
+ ********************************************************************/
+char SchedRun(void) {
+    SchedTask_t *t;
+    unsigned int now = SchedNow();
+    unsigned char i, id;
+
+    for (i = 0; i < _vSchedCount; i++) {
+        id = _vSchedOrder[i];
+        t = &_vSchedTasks[id];
+        if ((short) (now - t->due) >= 0) {
+            if ((short) (now - t->due) >= (short) t->period) {
+                t->overruns++;
+                t->due = now;
+            }
+            t->due += t->period;
+            TraceBegin(TR_TASK + id);
+            t->task();
+            TraceEnd(TR_TASK + id);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*********************************************************************
+ * Function         :unsigned int SchedOverruns(unsigned char id)
+ * PreCondition     :None
+ * Input            :id - from SchedAdd()
+ * Output           :Times the task was a whole period or more late
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+unsigned int SchedOverruns(unsigned char id) {
+    if (id >= _vSchedCount)
+        return 0;
+    return _vSchedTasks[id].overruns;
+}
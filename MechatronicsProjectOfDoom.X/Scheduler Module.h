@@ -0,0 +1,55 @@
+/*********************************************************************
+ * FileName:        Scheduler Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Cooperative scheduler.  Timer0 ticks every SCHED_TICK_US from
+ * low_isr; SchedRun() in the main loop runs the highest priority task
+ * that's due, to completion, and returns.  Tasks must not wait on
+ * anything - a task that holds the CPU delays every task behind it.
+ *
+ * Each task has a period and a phase (first run) in ticks and a
+ * priority, 0 is the most urgent.  If a task is late by a whole period
+ * or more its overrun counter goes up and it is rescheduled from now,
+ * the runs it missed are dropped rather than run back to back.
+ *
+ * In low_isr (a late tick doesn't shift the ones after it, see
+ * SchedTimerISR()):
+ *   if (INTCONbits.TMR0IF && INTCONbits.TMR0IE) SchedTimerISR();
+ *
+ * Everything except SchedInit() and SchedTimerISR() is plain C, on a
+ * host build (no __18CXX) call SchedTick() to move time on.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __SCHEDULER_MODULE_H
+#define __SCHEDULER_MODULE_H
+#include "Clock Module.h"
+
+#define SCHED_TICK_US       1000    // 1 ms tick
+#define SCHED_MAX_TASKS     10      // 10 bytes of RAM each
+#define SCHED_TMR0_FIXUP    6       // Timer0 counts lost around the reload in SchedTimerISR()
+#define SCHED_TMR0_RELOAD   (65536 - ClockTcy(SCHED_TICK_US) + SCHED_TMR0_FIXUP) // 1 count = 1 instruction
+
+#if ClockTcy(SCHED_TICK_US) > 65535
+#error "SCHED_TICK_US is too long for Timer0 at this clock"
+#endif
+
+#define SCHED_FULL          0xFF    // SchedAdd() when there's no room left
+
+#define SchedMs(ms)         ((unsigned int)((ms) * 1000UL / SCHED_TICK_US))
+
+void SchedInit(void); // Clears the task table and starts Timer0, needs RCONbits.IPEN and GIEL
+void SchedTimerISR(void); // Timer0 overflow
+void SchedTick(void); // Moves time on one tick, host builds (SchedTimerISR() on the PIC)
+
+// Adds a task, returns its id or SCHED_FULL
+unsigned char SchedAdd(void (*task)(void), unsigned int period, unsigned int phase,
+        unsigned char priority);
+char SchedRun(void); // Runs at most one due task, returns 1 if it did
+unsigned int SchedNow(void); // Ticks since SchedInit(), wraps
+unsigned int SchedOverruns(unsigned char id); // Times task id was a whole period late
+
+#endif
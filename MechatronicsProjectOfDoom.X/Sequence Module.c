@@ -0,0 +1,49 @@
+/*********************************************************************
+ * FileName:        Sequence Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Button sequence matcher, see Sequence Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Sequence Module.h"
+
+unsigned char _vSeqState = 0; //state in seqNext[], 0 = nothing matched yet
+
+/*********************************************************************
+ * Function         :void SeqInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void SeqInit(void) {
+    _vSeqState = 0;
+}
+
+/*********************************************************************
+ * Function         :unsigned char SeqFeed(char key)
+ * PreCondition     :None
+ * Input            :key - SEQ_FIRST to SEQ_FIRST + SEQ_SYMBOLS - 1
+ * Output           :Sequences ending with this press, bit n-1 = n
+ * Side Effects     :None
+ * Overview         :One table lookup for the next state, one for what
+ *                   it matches.  Overlapping sequences all report, so
+ *                   "acacac" matches acac twice.
+ * Note             :None
+ ********************************************************************/
+unsigned char SeqFeed(char key) {
+    unsigned char k = key - SEQ_FIRST;
+
+    if (k >= SEQ_SYMBOLS) {
+        _vSeqState = 0;
+        return 0;
+    }
+    _vSeqState = seqNext[(unsigned int) _vSeqState * SEQ_SYMBOLS + k];
+    return seqMatch[_vSeqState];
+}
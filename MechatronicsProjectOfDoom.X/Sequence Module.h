@@ -0,0 +1,34 @@
+/*********************************************************************
+ * FileName:        Sequence Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Button sequence matcher.  Feed it key presses one at a time and it
+ * says which sequences, if any, the last presses spell out.  The only
+ * RAM is the current state; the sequences are compiled into ROM tables
+ * in Sequence Table.c by tools/seqgen, so adding one costs no extra
+ * time per press.  To change them:
+ *
+ *   ./seqgen abbc bcaa acac > "MechatronicsProjectOfDoom.X/Sequence Table.c"
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __SEQUENCE_MODULE_H
+#define __SEQUENCE_MODULE_H
+
+#define SEQ_FIRST       'a'     // Keys are SEQ_FIRST ...
+#define SEQ_SYMBOLS     3       //   ... SEQ_FIRST + SEQ_SYMBOLS - 1
+
+void SeqInit(void); // Forget any presses so far
+// One press, returns the sequences it completes, bit n-1 = sequence n, 0 for none.
+// Keys outside the range start over.
+unsigned char SeqFeed(char key);
+
+// Sequence Table.c
+extern rom unsigned char seqCount;
+extern rom unsigned char seqNext[];
+extern rom unsigned char seqMatch[];
+
+#endif
@@ -0,0 +1,40 @@
+/*********************************************************************
+ * FileName:        Sequence Table.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Generated by tools/seqgen, don't edit.  Sequences:
+ *   1  abbc
+ *   2  bcaa
+ *   3  acac
+ ********************************************************************/
+
+#include "Sequence Module.h"
+
+#if SEQ_SYMBOLS != 3
+#error "Sequence Table.c was generated for 3 keys"
+#endif
+
+rom unsigned char seqCount = 3;
+
+// Next state, [state * SEQ_SYMBOLS + key]
+rom unsigned char seqNext[36] = {
+      1,  5,  0, // 0
+      1,  2,  9, // 1
+      1,  3,  6, // 2
+      1,  5,  4, // 3
+      7,  5,  0, // 4
+      1,  5,  6, // 5
+      7,  5,  0, // 6
+      8,  2,  9, // 7
+      1,  2,  9, // 8
+     10,  5,  0, // 9
+      1,  2, 11, // 10
+     10,  5,  0, // 11
+};
+
+// Sequences that end in each state, bit n-1 = sequence n
+rom unsigned char seqMatch[12] = {
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x02, 0x00, 0x00, 0x04,
+};
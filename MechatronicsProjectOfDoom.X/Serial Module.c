@@ -0,0 +1,127 @@
+/*********************************************************************
+ * FileName:        Serial Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Interrupt driven EUSART transmit, polled receive, see Serial Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include <p18f4520.h>
+#include "Serial Module.h"
+
+#if SERIAL_TX_SIZE & (SERIAL_TX_SIZE - 1) || SERIAL_TX_SIZE > 128
+#error "SERIAL_TX_SIZE must be a power of 2, up to 128"
+#endif
+
+unsigned char _vSerialTx[SERIAL_TX_SIZE];
+volatile unsigned char _vSerialHead = 0; //bytes queued, free running, SerialPut() only
+volatile unsigned char _vSerialTail = 0; //bytes sent, free running, SerialTxISR() only
+
+/*********************************************************************
+ * Function         :void SerialInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :Takes over the EUSART, RC6 and RC7
+ * Overview         :SERIAL_BAUD 8N1, receiver on but no RX interrupt
+ * Note             :The TX interrupt is only enabled while there is
+ *                   something to send
+ ********************************************************************/
+void SerialInit(void) {
+    _vSerialHead = 0;
+    _vSerialTail = 0;
+    TRISCbits.RC6 = 1; // the EUSART drives it once SPEN is set
+    TRISCbits.RC7 = 1;
+    SPBRGH = SERIAL_BRG >> 8;
+    SPBRG = SERIAL_BRG & 0xFF;
+    BAUDCON = 0b00001000; // BRG16
+    TXSTA = 0b00100100; // TXEN, async, BRGH
+    RCSTA = 0b10010000; // SPEN, CREN
+    IPR1bits.TXIP = 0; // low priority
+    PIE1bits.TXIE = 0;
+}
+
+/*********************************************************************
+ * Function         :void SerialTxISR(void)
+ * PreCondition     :PIR1bits.TXIF is set
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Moves the next byte into TXREG, which clears TXIF.
+ *                   Once the ring is empty the interrupt turns itself
+ *                   off, SerialPut() turns it back on.
+ * Note             :Call from low_isr
+ ********************************************************************/
+void SerialTxISR(void) {
+    unsigned char tail = _vSerialTail;
+
+    if (tail == _vSerialHead) {
+        PIE1bits.TXIE = 0;
+        return;
+    }
+    TXREG = _vSerialTx[tail & (SERIAL_TX_SIZE - 1)];
+    _vSerialTail = tail + 1;
+}
+
+/*********************************************************************
+ * Function         :char SerialPut(unsigned char data)
+ * PreCondition     :SerialInit() has been called
+ * Input            :data - byte to send
+ * Output           :1 if queued, 0 if the ring was full
+ * Side Effects     :None
+ * Overview         :Fills the slot, then publishes it by moving the head
+ * Note             :Main loop only, one writer
+ ********************************************************************/
+char SerialPut(unsigned char data) {
+    unsigned char head = _vSerialHead;
+
+    if ((unsigned char) (head - _vSerialTail) >= SERIAL_TX_SIZE)
+        return 0;
+    _vSerialTx[head & (SERIAL_TX_SIZE - 1)] = data;
+    _vSerialHead = head + 1;
+    PIE1bits.TXIE = 1;
+    return 1;
+}
+
+/*********************************************************************
+ * Function         :unsigned char SerialRoom(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :Free bytes in the ring
+ * Side Effects     :None
+ * Overview         :Can only grow until the next SerialPut()
+ * Note             :None
+ ********************************************************************/
+unsigned char SerialRoom(void) {
+    return SERIAL_TX_SIZE - (unsigned char) (_vSerialHead - _vSerialTail);
+}
+
+/*********************************************************************
+ * Function         :int SerialGet(void)
+ * PreCondition     :SerialInit() has been called
+ * Input            :None
+ * Output           :Next byte from the receiver, SERIAL_NONE if there
+ *                   isn't one
+ * Side Effects     :None
+ * Overview         :An overrun stops the receiver until CREN is
+ *                   cleared, so that is restarted and the FIFO lost.
+ *                   A byte with a framing error is read and dropped.
+ * Note             :Main loop only
+ ********************************************************************/
+int SerialGet(void) {
+    unsigned char data, framing;
+
+    if (RCSTAbits.OERR) {
+        RCSTAbits.CREN = 0;
+        RCSTAbits.CREN = 1;
+        return SERIAL_NONE;
+    }
+    if (!PIR1bits.RCIF)
+        return SERIAL_NONE;
+    framing = RCSTAbits.FERR; // goes with the byte about to be read
+    data = RCREG;
+    return framing ? SERIAL_NONE : data;
+}
@@ -0,0 +1,50 @@
+/*********************************************************************
+ * FileName:        Serial Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Interrupt driven EUSART transmit.  SerialPut() drops a byte into a
+ * RAM ring and returns, the TX interrupt (low priority) sends it.
+ * Nothing ever waits on the line, a full ring refuses the byte
+ * instead, so callers check SerialRoom() for anything that has to go
+ * out whole.
+ *
+ * Receive is polled, SerialGet() takes whatever is in the EUSART's 2
+ * byte FIFO.  That is only enough for commands typed a key at a time,
+ * polled every few ms; anything that overruns it is thrown away.
+ *
+ *	Wiring:
+ *		RC6 (TX)	- to the RX of a 3.3/5 V USB serial adapter
+ *		RC7 (RX)	- from the TX of the adapter
+ *   SERIAL_BAUD 8N1.
+ *
+ * In low_isr:
+ *   if (PIR1bits.TXIF && PIE1bits.TXIE) SerialTxISR();
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __SERIAL_MODULE_H
+#define __SERIAL_MODULE_H
+#include "Clock Module.h"
+
+#define SERIAL_BAUD     38400UL
+#define SERIAL_TX_SIZE  64      // Bytes, must be a power of 2 (up to 128)
+
+// BRGH = 1, BRG16 = 1: baud = Fosc / (4 * (SPBRG + 1)), rounded to the nearest
+#define SERIAL_BRG      ((CLOCK_FOSC + 2 * SERIAL_BAUD) / (4 * SERIAL_BAUD) - 1)
+#define SERIAL_ACTUAL   (CLOCK_FOSC / (4 * (SERIAL_BRG + 1)))
+#if SERIAL_ACTUAL * 100 > SERIAL_BAUD * 102 || SERIAL_ACTUAL * 100 < SERIAL_BAUD * 98
+#error "SERIAL_BAUD is more than 2% out at this clock"
+#endif
+
+#define SERIAL_NONE     -1      // SerialGet() with nothing received
+
+void SerialInit(void); // TX on RC6, interrupt at low priority, needs RCONbits.IPEN and GIEL
+void SerialTxISR(void); // TX register empty
+char SerialPut(unsigned char data); // Returns 0, and sends nothing, if the ring is full
+unsigned char SerialRoom(void); // Bytes SerialPut() will take right now
+int SerialGet(void); // Next received byte or SERIAL_NONE
+
+#endif
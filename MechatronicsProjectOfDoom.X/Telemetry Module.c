@@ -0,0 +1,140 @@
+/*********************************************************************
+ * FileName:        Telemetry Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * IR reading telemetry, see Telemetry Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include "Telemetry Module.h"
+#include "Serial Module.h"
+#include "Trace Module.h"
+
+unsigned int TelemetryDrops = 0;
+unsigned int TelemetryGaps = 0;
+
+#ifdef TELEMETRY_ENABLE
+
+#if defined(TRACE_ENABLE)
+#error "Telemetry and the trace snapshots share the serial port, comment out one of them"
+#endif
+#if TELEM_SAMPLES % 4 || TELEM_BYTES > SERIAL_TX_SIZE
+#error "TELEM_SAMPLES must be a multiple of 4 and a record must fit in the serial ring"
+#endif
+
+int _vTelSample[TELEM_SAMPLES];
+unsigned char _vTelCount = 0; //samples in the record so far
+unsigned char _vTelFirst; //ADC seq of _vTelSample[0]
+unsigned char _vTelSeq = 0; //record number
+char _vTelHold = 0; //records dropped while other text goes out
+
+/*********************************************************************
+ * Function         :void TelemetryInit(void)
+ * PreCondition     :None
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :None
+ * Note             :None
+ ********************************************************************/
+void TelemetryInit(void) {
+    _vTelCount = 0;
+    _vTelSeq = 0;
+    _vTelHold = 0;
+    TelemetryDrops = 0;
+    TelemetryGaps = 0;
+}
+
+/*********************************************************************
+ * Function         :static void TelemetrySend(void)
+ * PreCondition     :TELEM_SAMPLES samples collected
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Packs the record into the serial ring if all of it
+ *                   fits and it isn't held back, counts a drop if not.
+ *                   The record number goes up either way so the drop
+ *                   shows at the far end.
+ * Note             :None
+ ********************************************************************/
+static void TelemetrySend(void) {
+    unsigned char i, j, b, sum;
+    unsigned long lo;
+
+    if (_vTelHold || SerialRoom() < TELEM_BYTES) {
+        TelemetryDrops++;
+        _vTelSeq++;
+        return;
+    }
+    SerialPut(TELEM_SYNC1);
+    SerialPut(TELEM_SYNC2);
+    SerialPut(_vTelSeq);
+    SerialPut(_vTelFirst);
+    SerialPut((unsigned char) TelemetryDrops);
+    SerialPut((unsigned char) TelemetryGaps);
+    sum = _vTelSeq + _vTelFirst + (unsigned char) TelemetryDrops + (unsigned char) TelemetryGaps;
+    for (i = 0; i < TELEM_SAMPLES; i += 4) {
+        lo = 0;
+        for (j = 0; j < 4; j++) {
+            b = (unsigned char) (_vTelSample[i + j] >> TELEM_LOW_BITS);
+            SerialPut(b);
+            sum += b;
+            lo |= (unsigned long) (_vTelSample[i + j] & ((1 << TELEM_LOW_BITS) - 1)) << (TELEM_LOW_BITS * j);
+        }
+        for (j = 0; j < TELEM_LOW_BYTES; j++) {
+            b = (unsigned char) lo;
+            SerialPut(b);
+            sum += b;
+            lo >>= 8;
+        }
+    }
+    SerialPut(sum);
+    _vTelSeq++;
+}
+
+/*********************************************************************
+ * Function         :void TelemetryAdd(int value, unsigned char seq)
+ * PreCondition     :SerialInit() has been called
+ * Input            :value - reading, 0 to ADC_MAX
+ *                   seq - its ADCNext() sequence number
+ * Output           :None
+ * Side Effects     :Sends a record every TELEM_SAMPLES calls
+ * Overview         :A seq that doesn't follow on from the last one
+ *                   throws the part record away (TelemetryGaps) and
+ *                   starts a new one with this sample.
+ * Note             :Main loop only (the serial ring has one writer)
+ ********************************************************************/
+void TelemetryAdd(int value, unsigned char seq) {
+    if (_vTelCount && seq != (unsigned char) (_vTelFirst + _vTelCount)) {
+        TelemetryGaps++;
+        _vTelCount = 0;
+    }
+    if (_vTelCount == 0)
+        _vTelFirst = seq;
+    _vTelSample[_vTelCount] = value;
+    if (++_vTelCount < TELEM_SAMPLES)
+        return;
+    TelemetrySend();
+    _vTelCount = 0;
+}
+
+/*********************************************************************
+ * Function         :void TelemetryHold(char on)
+ * PreCondition     :None
+ * Input            :on - 1 to drop the records, 0 to send them again
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :For text going out of the same port: held from
+ *                   before its first line until its last is in the
+ *                   serial ring, the text comes out between two whole
+ *                   records and the ones in between count as drops.
+ * Note             :Main loop only
+ ********************************************************************/
+void TelemetryHold(char on) {
+    _vTelHold = on;
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*********************************************************************
+ * FileName:        Telemetry Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * IR readings out of the serial port at the full sample rate, for
+ * tuning the IR Module thresholds off the board.  TelemetryAdd() takes
+ * every raw reading, the sampling task gets each of them from the ADC
+ * interrupt's ring (ADCNext()) however late it runs; TELEM_SAMPLES are
+ * packed into one record and handed to the serial ring whole, or, if
+ * there isn't room for all of it, dropped and counted.  Nothing waits
+ * on the port.
+ *
+ * The 'd', 'i' and 's' text replies go out of RC6 too.  The command
+ * task holds the records back (TelemetryHold()) from the command until
+ * the last line is in the ring, so a dump comes out between two
+ * records and not in place of them; the records held back are counted
+ * as drops.
+ *
+ * Samples go out whole, ADC_BITS each, oversampling bits included.
+ *
+ * Record, TELEM_BYTES (17 at 10 bits, 19 at 11 or 12, 21 at 13),
+ * SERIAL_BAUD 8N1 (1 kHz sampling at 10 bits uses 55% of the link):
+ *   0xC3 0x3C  record seq  ADC seq of the first sample
+ *   TelemetryDrops  TelemetryGaps, low bytes, as of this record
+ *   2 x (4 samples: the top 8 bits of each, then the other ADC_BITS - 8
+ *        bits of all four packed into TELEM_LOW_BYTES, low byte first,
+ *        first sample in the lowest bits)
+ *   sum - low byte of the sum of every byte after the 0xC3 0x3C
+ * At 10 bits that is bits 9:2 of each and one byte of bits 1:0.
+ * The samples in a record are consecutive ADC samples.  A missed
+ * sample (the task fell more than ADC_RING samples behind) ends the
+ * record early and it is dropped.
+ *
+ * The serial port carries either this or the trace snapshots, not
+ * both, their records would get mixed up.  tools/telemcap turns a
+ * capture (or the port itself) into CSV.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __TELEMETRY_MODULE_H
+#define __TELEMETRY_MODULE_H
+
+#include "ADC Module.h"
+
+#define TELEMETRY_ENABLE        // Comment out to send nothing (TelemetryAdd() does nothing)
+#define TELEM_SAMPLES   8       // Per record, a multiple of 4
+#define TELEM_LOW_BITS  (ADC_BITS - 8) // Bits of each sample after the top 8
+#define TELEM_LOW_BYTES ((4 * TELEM_LOW_BITS + 7) / 8) // ... of four samples, packed
+#define TELEM_BYTES     (6 + TELEM_SAMPLES / 4 * (4 + TELEM_LOW_BYTES) + 1)
+
+#define TELEM_SYNC1     0xC3
+#define TELEM_SYNC2     0x3C
+
+#ifdef TELEMETRY_ENABLE
+void TelemetryInit(void);
+void TelemetryAdd(int value, unsigned char seq); // One raw reading (ADC_BITS), seq from ADCNext()
+void TelemetryHold(char on); // 1 drops the records while other text goes out, 0 sends them again
+#else
+#define TelemetryInit()
+#define TelemetryAdd(value, seq)
+#define TelemetryHold(on)
+#endif
+
+extern unsigned int TelemetryDrops; // Records the serial ring had no room for, or held back
+extern unsigned int TelemetryGaps; // Records cut short by a missed sample
+
+#endif
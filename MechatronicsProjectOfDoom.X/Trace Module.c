@@ -0,0 +1,85 @@
+/*********************************************************************
+ * FileName:        Trace Module.c
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Trace snapshots, see Trace Module.h
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#include <p18f4520.h>
+#include "Trace Module.h"
+#include "Serial Module.h"
+
+#ifdef TRACE_ENABLE
+
+#define TRACE_BYTES     (4 + 3 * TRACE_SIZE + 1) // one snapshot on the wire
+#if TRACE_BYTES > 255
+#error "TRACE_SIZE is too big for one snapshot"
+#endif
+
+volatile unsigned char _vTraceHead = 0;
+unsigned char _vTraceId[TRACE_SIZE];
+unsigned char _vTraceLo[TRACE_SIZE];
+unsigned char _vTraceHi[TRACE_SIZE];
+
+unsigned char _vTraceSeq = 0; //snapshot number
+unsigned char _vTracePos = 0; //bytes of this snapshot sent
+unsigned char _vTraceSum = 0;
+
+/*********************************************************************
+ * Function         :void TraceDrain(void)
+ * PreCondition     :SerialInit() has been called
+ * Input            :None
+ * Output           :None
+ * Side Effects     :None
+ * Overview         :Nothing until the snapshot is full, then sends as
+ *                   much of it as the serial ring has room for and
+ *                   carries on next time.  Once the sum has gone the
+ *                   buffer is emptied, which starts the next snapshot.
+ * Note             :Main loop only
+ ********************************************************************/
+void TraceDrain(void) {
+    unsigned char pos, i, b;
+
+    if (_vTraceHead < TRACE_SIZE)
+        return; // still filling
+    pos = _vTracePos;
+    while (pos < TRACE_BYTES && SerialRoom()) {
+        if (pos == 0)
+            b = TRACE_SYNC1;
+        else if (pos == 1)
+            b = TRACE_SYNC2;
+        else if (pos == 2)
+            b = _vTraceSeq;
+        else if (pos == 3)
+            b = TRACE_SIZE;
+        else if (pos < TRACE_BYTES - 1) {
+            i = (pos - 4) / 3;
+            switch ((pos - 4) % 3) {
+                case 0: b = _vTraceId[i];
+                    break;
+                case 1: b = _vTraceLo[i];
+                    break;
+                default: b = _vTraceHi[i];
+                    break;
+            }
+        } else
+            b = _vTraceSum;
+        if (pos >= 2)
+            _vTraceSum += b;
+        SerialPut(b);
+        pos++;
+    }
+    _vTracePos = pos;
+    if (pos < TRACE_BYTES)
+        return;
+    _vTraceSeq++;
+    _vTracePos = 0;
+    _vTraceSum = 0;
+    _vTraceHead = 0; // last, the trace points start filling again
+}
+
+#endif
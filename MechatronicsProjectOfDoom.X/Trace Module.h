@@ -0,0 +1,83 @@
+/*********************************************************************
+ * FileName:        Trace Module.h
+ * Processor:       PIC18F4520
+ * Compiler:        MPLAB C18 v.3.06
+ *
+ * Trace points.  TraceBegin(id)/TraceEnd(id) store the id and the
+ * Timer1 time (1 us per count, see ClockStamp()) in a RAM buffer, in
+ * line and with no calls, so they can go in the interrupts.  Each is
+ * about 38 instructions, counted by hand from what C18 makes of it:
+ * 8 checking and moving the index on, 22 working out the address and
+ * storing each of the three bytes, and 8 saving GIEH, holding it off
+ * over the Timer1 read and putting it back.  In high_isr and the
+ * functions only it calls GIEH is off already, so TraceBeginHigh()/
+ * TraceEndHigh() leave it alone, about 30.
+ * Without TRACE_ENABLE every one of them, the buffer and
+ * TraceDrain() compile to nothing.  The snapshots go out of the serial
+ * port in place of the telemetry (Telemetry Module.h).
+ *
+ * The buffer is a snapshot: it fills with the next TRACE_SIZE points,
+ * then TraceDrain() (a task) sends it out over the serial port and
+ * starts the next one.  Points that come while it is being sent are
+ * not recorded, so each snapshot is a complete stretch of time.
+ * tools/tracedump turns a capture of the serial port into a timeline
+ * and histograms of how long each span took and how often it came.
+ *
+ * A point in the main loop or low_isr that is interrupted by one in
+ * high_isr between taking its slot and moving the index on loses the
+ * high_isr point, which is a 2 instruction window.
+ *
+ * Snapshot on the wire, SERIAL_BAUD 8N1:
+ *   0xA5 0x5A seq count  then count x (id, time low, time high)  then sum
+ * sum is the low byte of the sum of every byte after the 0xA5 0x5A.
+ *
+ * Author               Date    Comment
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ ********************************************************************/
+
+#ifndef __TRACE_MODULE_H
+#define __TRACE_MODULE_H
+
+//#define TRACE_ENABLE          // Compiles the trace points in, comment out TELEMETRY_ENABLE too
+#define TRACE_SIZE      64      // Points per snapshot, 3 bytes of RAM each
+
+// Ids, bit 7 set marks the end of a span
+#define TR_HIGH         0x01    // high_isr
+#define TR_LOW          0x02    // low_isr
+#define TR_ADC          0x03    // ADCTimerISR() starting a conversion to ADCSampleISR()
+#define TR_LCD_PUT      0x04    // XLCDPutRamString(), including waiting for queue room
+#define TR_TASK         0x10    // + scheduler id (0 to SCHED_MAX_TASKS - 1), one task run
+#define TR_END          0x80
+
+#define TRACE_SYNC1     0xA5
+#define TRACE_SYNC2     0x5A
+
+#if defined(TRACE_ENABLE) && defined(__18CXX)
+extern volatile unsigned char _vTraceHead; //next free point, TRACE_SIZE = full
+extern unsigned char _vTraceId[TRACE_SIZE];
+extern unsigned char _vTraceLo[TRACE_SIZE];
+extern unsigned char _vTraceHi[TRACE_SIZE];
+
+// Reading TMR1L latches TMR1H, GIEH is held off over the two reads as in ClockRead()
+#define TracePoint(id)  do { unsigned char _t = _vTraceHead, _g; \
+                          if (_t < TRACE_SIZE) { _vTraceHead = _t + 1; _vTraceId[_t] = (id); \
+                              _g = INTCONbits.GIEH; INTCONbits.GIEH = 0; \
+                              _vTraceLo[_t] = TMR1L; _vTraceHi[_t] = TMR1H; \
+                              INTCONbits.GIEH = _g; } } while (0)
+// high_isr only, nothing can come in between
+#define TracePointHigh(id) do { unsigned char _t = _vTraceHead; \
+                          if (_t < TRACE_SIZE) { _vTraceHead = _t + 1; _vTraceId[_t] = (id); \
+                              _vTraceLo[_t] = TMR1L; _vTraceHi[_t] = TMR1H; } } while (0)
+void TraceDrain(void); // Task, every 10 ms or so: sends a full snapshot, then starts the next
+#else
+#define TracePoint(id)
+#define TracePointHigh(id)
+#define TraceDrain()
+#endif
+
+#define TraceBegin(id)  TracePoint(id)
+#define TraceEnd(id)    TracePoint((id) | TR_END)
+#define TraceBeginHigh(id) TracePointHigh(id)
+#define TraceEndHigh(id) TracePointHigh((id) | TR_END)
+
+#endif
@@ -45,17 +45,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED="LCD Module.c" MechatronicsProject.c
+SOURCEFILES_QUOTED_IF_SPACED="ADC Module.c" "Clock Module.c" "Door Module.c" "Event Module.c" "Filter Module.c" "IR Module.c" "Interrupt Module.c" "Keycard Module.c" "LCD Buffer.c" "LCD Format.c" "LCD Glyph.c" "LCD Module.c" "LCD Screen.c" "Lock Module.c" MechatronicsProject.c "Motor Module.c" "Power Module.c" "Profile Module.c" "Scheduler Module.c" "Sequence Module.c" "Sequence Table.c" "Serial Module.c" "Telemetry Module.c" "Trace Module.c"
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED="${OBJECTDIR}/LCD Module.o" ${OBJECTDIR}/MechatronicsProject.o
-POSSIBLE_DEPFILES="${OBJECTDIR}/LCD Module.o.d" ${OBJECTDIR}/MechatronicsProject.o.d
+OBJECTFILES_QUOTED_IF_SPACED="${OBJECTDIR}/ADC Module.o" "${OBJECTDIR}/Clock Module.o" "${OBJECTDIR}/Door Module.o" "${OBJECTDIR}/Event Module.o" "${OBJECTDIR}/Filter Module.o" "${OBJECTDIR}/IR Module.o" "${OBJECTDIR}/Interrupt Module.o" "${OBJECTDIR}/Keycard Module.o" "${OBJECTDIR}/LCD Buffer.o" "${OBJECTDIR}/LCD Format.o" "${OBJECTDIR}/LCD Glyph.o" "${OBJECTDIR}/LCD Module.o" "${OBJECTDIR}/LCD Screen.o" "${OBJECTDIR}/Lock Module.o" ${OBJECTDIR}/MechatronicsProject.o "${OBJECTDIR}/Motor Module.o" "${OBJECTDIR}/Power Module.o" "${OBJECTDIR}/Profile Module.o" "${OBJECTDIR}/Scheduler Module.o" "${OBJECTDIR}/Sequence Module.o" "${OBJECTDIR}/Sequence Table.o" "${OBJECTDIR}/Serial Module.o" "${OBJECTDIR}/Telemetry Module.o" "${OBJECTDIR}/Trace Module.o"
+POSSIBLE_DEPFILES="${OBJECTDIR}/ADC Module.o.d" "${OBJECTDIR}/Clock Module.o.d" "${OBJECTDIR}/Door Module.o.d" "${OBJECTDIR}/Event Module.o.d" "${OBJECTDIR}/Filter Module.o.d" "${OBJECTDIR}/IR Module.o.d" "${OBJECTDIR}/Interrupt Module.o.d" "${OBJECTDIR}/Keycard Module.o.d" "${OBJECTDIR}/LCD Buffer.o.d" "${OBJECTDIR}/LCD Format.o.d" "${OBJECTDIR}/LCD Glyph.o.d" "${OBJECTDIR}/LCD Module.o.d" "${OBJECTDIR}/LCD Screen.o.d" "${OBJECTDIR}/Lock Module.o.d" ${OBJECTDIR}/MechatronicsProject.o.d "${OBJECTDIR}/Motor Module.o.d" "${OBJECTDIR}/Power Module.o.d" "${OBJECTDIR}/Profile Module.o.d" "${OBJECTDIR}/Scheduler Module.o.d" "${OBJECTDIR}/Sequence Module.o.d" "${OBJECTDIR}/Sequence Table.o.d" "${OBJECTDIR}/Serial Module.o.d" "${OBJECTDIR}/Telemetry Module.o.d" "${OBJECTDIR}/Trace Module.o.d"
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/LCD\ Module.o ${OBJECTDIR}/MechatronicsProject.o
+OBJECTFILES=${OBJECTDIR}/ADC\ Module.o ${OBJECTDIR}/Clock\ Module.o ${OBJECTDIR}/Door\ Module.o ${OBJECTDIR}/Event\ Module.o ${OBJECTDIR}/Filter\ Module.o ${OBJECTDIR}/IR\ Module.o ${OBJECTDIR}/Interrupt\ Module.o ${OBJECTDIR}/Keycard\ Module.o ${OBJECTDIR}/LCD\ Buffer.o ${OBJECTDIR}/LCD\ Format.o ${OBJECTDIR}/LCD\ Glyph.o ${OBJECTDIR}/LCD\ Module.o ${OBJECTDIR}/LCD\ Screen.o ${OBJECTDIR}/Lock\ Module.o ${OBJECTDIR}/MechatronicsProject.o ${OBJECTDIR}/Motor\ Module.o ${OBJECTDIR}/Power\ Module.o ${OBJECTDIR}/Profile\ Module.o ${OBJECTDIR}/Scheduler\ Module.o ${OBJECTDIR}/Sequence\ Module.o ${OBJECTDIR}/Sequence\ Table.o ${OBJECTDIR}/Serial\ Module.o ${OBJECTDIR}/Telemetry\ Module.o ${OBJECTDIR}/Trace\ Module.o
 
 # Source Files
-SOURCEFILES=LCD Module.c MechatronicsProject.c
+SOURCEFILES=ADC Module.c Clock Module.c Door Module.c Event Module.c Filter Module.c IR Module.c Interrupt Module.c Keycard Module.c LCD Buffer.c LCD Format.c LCD Glyph.c LCD Module.c LCD Screen.c Lock Module.c MechatronicsProject.c Motor Module.c Power Module.c Profile Module.c Scheduler Module.c Sequence Module.c Sequence Table.c Serial Module.c Telemetry Module.c Trace Module.c
 
 
 CFLAGS=
@@ -89,6 +89,94 @@ endif
 # ------------------------------------------------------------------------------------
 # Rules for buildStep: compile
 ifeq ($(TYPE_IMAGE), DEBUG_RUN)
+${OBJECTDIR}/ADC\ Module.o: ADC\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/ADC\ Module.o.d 
+	@${RM} "${OBJECTDIR}/ADC Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/ADC Module.o"   "ADC Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/ADC Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/ADC Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Clock\ Module.o: Clock\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Clock\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Clock Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Clock Module.o"   "Clock Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Clock Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Clock Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Door\ Module.o: Door\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Door\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Door Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Door Module.o"   "Door Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Door Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Door Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Event\ Module.o: Event\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Event\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Event Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Event Module.o"   "Event Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Event Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Event Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Filter\ Module.o: Filter\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Filter\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Filter Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Filter Module.o"   "Filter Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Filter Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Filter Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/IR\ Module.o: IR\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/IR\ Module.o.d 
+	@${RM} "${OBJECTDIR}/IR Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/IR Module.o"   "IR Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/IR Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/IR Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Interrupt\ Module.o: Interrupt\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Interrupt\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Interrupt Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Interrupt Module.o"   "Interrupt Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Interrupt Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Interrupt Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Keycard\ Module.o: Keycard\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Keycard\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Keycard Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Keycard Module.o"   "Keycard Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Keycard Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Keycard Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/LCD\ Buffer.o: LCD\ Buffer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Buffer.o.d 
+	@${RM} "${OBJECTDIR}/LCD Buffer.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Buffer.o"   "LCD Buffer.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Buffer.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Buffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/LCD\ Format.o: LCD\ Format.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Format.o.d 
+	@${RM} "${OBJECTDIR}/LCD Format.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Format.o"   "LCD Format.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Format.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Format.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/LCD\ Glyph.o: LCD\ Glyph.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Glyph.o.d 
+	@${RM} "${OBJECTDIR}/LCD Glyph.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Glyph.o"   "LCD Glyph.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Glyph.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Glyph.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
 ${OBJECTDIR}/LCD\ Module.o: LCD\ Module.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR} 
 	@${RM} ${OBJECTDIR}/LCD\ Module.o.d 
@@ -97,6 +185,22 @@ ${OBJECTDIR}/LCD\ Module.o: LCD\ Module.c  nbproject/Makefile-${CND_CONF}.mk
 	@${DEP_GEN} -d "${OBJECTDIR}/LCD Module.o" 
 	@${FIXDEPS} "${OBJECTDIR}/LCD Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
 	
+${OBJECTDIR}/LCD\ Screen.o: LCD\ Screen.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Screen.o.d 
+	@${RM} "${OBJECTDIR}/LCD Screen.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Screen.o"   "LCD Screen.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Screen.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Screen.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Lock\ Module.o: Lock\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Lock\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Lock Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Lock Module.o"   "Lock Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Lock Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Lock Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
 ${OBJECTDIR}/MechatronicsProject.o: MechatronicsProject.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR} 
 	@${RM} ${OBJECTDIR}/MechatronicsProject.o.d 
@@ -105,7 +209,167 @@ ${OBJECTDIR}/MechatronicsProject.o: MechatronicsProject.c  nbproject/Makefile-${
 	@${DEP_GEN} -d ${OBJECTDIR}/MechatronicsProject.o 
 	@${FIXDEPS} "${OBJECTDIR}/MechatronicsProject.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
 	
+${OBJECTDIR}/Motor\ Module.o: Motor\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Motor\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Motor Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Motor Module.o"   "Motor Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Motor Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Motor Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Power\ Module.o: Power\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Power\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Power Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Power Module.o"   "Power Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Power Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Power Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Profile\ Module.o: Profile\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Profile\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Profile Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Profile Module.o"   "Profile Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Profile Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Profile Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Scheduler\ Module.o: Scheduler\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Scheduler\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Scheduler Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Scheduler Module.o"   "Scheduler Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Scheduler Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Scheduler Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Sequence\ Module.o: Sequence\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Sequence\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Sequence Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Sequence Module.o"   "Sequence Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Sequence Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Sequence Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Sequence\ Table.o: Sequence\ Table.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Sequence\ Table.o.d 
+	@${RM} "${OBJECTDIR}/Sequence Table.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Sequence Table.o"   "Sequence Table.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Sequence Table.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Sequence Table.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Serial\ Module.o: Serial\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Serial\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Serial Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Serial Module.o"   "Serial Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Serial Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Serial Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Telemetry\ Module.o: Telemetry\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Telemetry\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Telemetry Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Telemetry Module.o"   "Telemetry Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Telemetry Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Telemetry Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Trace\ Module.o: Trace\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Trace\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Trace Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -D__DEBUG -D__MPLAB_DEBUGGER_PK3=1 -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Trace Module.o"   "Trace Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Trace Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Trace Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
 else
+${OBJECTDIR}/ADC\ Module.o: ADC\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/ADC\ Module.o.d 
+	@${RM} "${OBJECTDIR}/ADC Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/ADC Module.o"   "ADC Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/ADC Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/ADC Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Clock\ Module.o: Clock\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Clock\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Clock Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Clock Module.o"   "Clock Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Clock Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Clock Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Door\ Module.o: Door\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Door\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Door Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Door Module.o"   "Door Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Door Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Door Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Event\ Module.o: Event\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Event\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Event Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Event Module.o"   "Event Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Event Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Event Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Filter\ Module.o: Filter\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Filter\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Filter Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Filter Module.o"   "Filter Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Filter Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Filter Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/IR\ Module.o: IR\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/IR\ Module.o.d 
+	@${RM} "${OBJECTDIR}/IR Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/IR Module.o"   "IR Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/IR Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/IR Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Interrupt\ Module.o: Interrupt\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Interrupt\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Interrupt Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Interrupt Module.o"   "Interrupt Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Interrupt Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Interrupt Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Keycard\ Module.o: Keycard\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Keycard\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Keycard Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Keycard Module.o"   "Keycard Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Keycard Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Keycard Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/LCD\ Buffer.o: LCD\ Buffer.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Buffer.o.d 
+	@${RM} "${OBJECTDIR}/LCD Buffer.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Buffer.o"   "LCD Buffer.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Buffer.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Buffer.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/LCD\ Format.o: LCD\ Format.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Format.o.d 
+	@${RM} "${OBJECTDIR}/LCD Format.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Format.o"   "LCD Format.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Format.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Format.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/LCD\ Glyph.o: LCD\ Glyph.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Glyph.o.d 
+	@${RM} "${OBJECTDIR}/LCD Glyph.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Glyph.o"   "LCD Glyph.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Glyph.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Glyph.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
 ${OBJECTDIR}/LCD\ Module.o: LCD\ Module.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR} 
 	@${RM} ${OBJECTDIR}/LCD\ Module.o.d 
@@ -114,6 +378,22 @@ ${OBJECTDIR}/LCD\ Module.o: LCD\ Module.c  nbproject/Makefile-${CND_CONF}.mk
 	@${DEP_GEN} -d "${OBJECTDIR}/LCD Module.o" 
 	@${FIXDEPS} "${OBJECTDIR}/LCD Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
 	
+${OBJECTDIR}/LCD\ Screen.o: LCD\ Screen.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/LCD\ Screen.o.d 
+	@${RM} "${OBJECTDIR}/LCD Screen.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/LCD Screen.o"   "LCD Screen.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/LCD Screen.o" 
+	@${FIXDEPS} "${OBJECTDIR}/LCD Screen.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Lock\ Module.o: Lock\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Lock\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Lock Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Lock Module.o"   "Lock Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Lock Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Lock Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
 ${OBJECTDIR}/MechatronicsProject.o: MechatronicsProject.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} ${OBJECTDIR} 
 	@${RM} ${OBJECTDIR}/MechatronicsProject.o.d 
@@ -122,6 +402,78 @@ ${OBJECTDIR}/MechatronicsProject.o: MechatronicsProject.c  nbproject/Makefile-${
 	@${DEP_GEN} -d ${OBJECTDIR}/MechatronicsProject.o 
 	@${FIXDEPS} "${OBJECTDIR}/MechatronicsProject.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
 	
+${OBJECTDIR}/Motor\ Module.o: Motor\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Motor\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Motor Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Motor Module.o"   "Motor Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Motor Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Motor Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Power\ Module.o: Power\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Power\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Power Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Power Module.o"   "Power Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Power Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Power Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Profile\ Module.o: Profile\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Profile\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Profile Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Profile Module.o"   "Profile Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Profile Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Profile Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Scheduler\ Module.o: Scheduler\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Scheduler\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Scheduler Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Scheduler Module.o"   "Scheduler Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Scheduler Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Scheduler Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Sequence\ Module.o: Sequence\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Sequence\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Sequence Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Sequence Module.o"   "Sequence Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Sequence Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Sequence Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Sequence\ Table.o: Sequence\ Table.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Sequence\ Table.o.d 
+	@${RM} "${OBJECTDIR}/Sequence Table.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Sequence Table.o"   "Sequence Table.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Sequence Table.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Sequence Table.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Serial\ Module.o: Serial\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Serial\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Serial Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Serial Module.o"   "Serial Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Serial Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Serial Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Telemetry\ Module.o: Telemetry\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Telemetry\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Telemetry Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Telemetry Module.o"   "Telemetry Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Telemetry Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Telemetry Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
+${OBJECTDIR}/Trace\ Module.o: Trace\ Module.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} ${OBJECTDIR} 
+	@${RM} ${OBJECTDIR}/Trace\ Module.o.d 
+	@${RM} "${OBJECTDIR}/Trace Module.o" 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -p$(MP_PROCESSOR_OPTION) -ms -oa-  -I ${MP_CC_DIR}\\..\\h  -fo "${OBJECTDIR}/Trace Module.o"   "Trace Module.c" 
+	@${DEP_GEN} -d "${OBJECTDIR}/Trace Module.o" 
+	@${FIXDEPS} "${OBJECTDIR}/Trace Module.o.d" $(SILENT) -rsi ${MP_CC_DIR}../ -c18 
+	
 endif
 
 # ------------------------------------------------------------------------------------
@@ -0,0 +1,230 @@
+/*********************************************************************
+ * FileName:        adcscan.c
+ * Processor:       Host (gcc)
+ *
+ * Runs ADC Module.c's channel scan against a timed model of Timer3 and
+ * the converter (registers from tools/oversim/adchost.h) and checks:
+ *
+ *   routing     every list position gets the reading of its own ANx
+ *   period      each channel's stamps are ADC_SAMPLE_US apart, give or
+ *               take the interrupt latency, and don't drift
+ *   slots       every burst is published before the next overflow
+ *   settling    from the multiplexer switch to the end of the next
+ *               acquisition is never under ADC_TACQ_NS
+ *   ADCStart()  one scan of the whole list in ADCSlow(1), back at 0
+ *   ring        ADCNext() called 0 to ADC_RING + 2 scans late gets the
+ *               IR samples in order, and the oldest left after falling
+ *               more than ADC_RING behind
+ *
+ * then prints the scan cycle and its cost for 1, 4 and 8 channels at
+ * this clock and ADC_OVERSAMPLE_BITS: the shortest scan the #errors in
+ * ADC Module.h let through, and whether ADC_SAMPLE_US is long enough.
+ *
+ *   gcc -Wall -I tools/oversim -I MechatronicsProjectOfDoom.X -o adcscan \
+ *       tools/adcscan/adcscan.c "MechatronicsProjectOfDoom.X/ADC Module.c"
+ *   ./adcscan [latency]        (worst interrupt latency in us, 20 by default)
+ *
+ * -DADC_CHANNELS=4 "-DADC_CHANNEL_LIST=0,1,2,4" scans a list (examples.sh
+ * builds the ones ADC Module.h gives),
+ * -DADC_SAMPLE_US, -DADC_OVERSAMPLE_BITS and -DCLOCK_FOSC change the
+ * rest, the same as on the PIC.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "adchost.h"
+#include "ADC Module.h"
+
+volatile unsigned char ADRESH, ADRESL, ADCON1, ADCON2, TMR3H, TMR3L, T3CON;
+volatile HostADCON0_t HostADCON0;
+volatile HostPIR1bits_t PIR1bits, PIE1bits, IPR1bits;
+volatile HostPIR2bits_t PIR2bits, PIE2bits, IPR2bits;
+volatile HostT3CONbits_t T3CONbits;
+
+extern unsigned char _vADCpos;
+
+// Estimated instruction cycles, as in tools/oversim
+#define TCY_TIMER       45      // high_isr with ADCTimerISR(): reload, GO, stamp
+#define TCY_PUBLISH     57      // end of the burst: round, shift, stamp, IR ring, next channel
+
+#define SCANS           1000    // scan cycles simulated
+#define TCY_NS          (1000L / CLOCK_TCY_PER_US)
+
+static const unsigned char list[ADC_CHANNELS] = {ADC_CHANNEL_LIST};
+static long now; // ns
+static long latency = 20;
+static int errors;
+
+unsigned int ClockStamp(void) {
+    return (unsigned int) (now / 1000);
+}
+
+// Noise free reading of each ANx, different for every input
+static int Input(unsigned char an) {
+    return 100 + 111 * an;
+}
+
+static void Error(const char *what, long n) {
+    if (errors++ < 10)
+        printf("  ** %s (%ld)\n", what, n);
+}
+
+// Conversions from a GO at now until GO stays clear, returns the smallest
+// settling time seen after a channel switch (ns), or -1 if there was none
+static long Convert(long *switched) {
+    long settle = -1, s, go;
+    int code;
+    unsigned char chs;
+
+    while (ADCON0bits.GO) {
+        go = now;
+        chs = ADCON0bits.CHS;
+        if (*switched >= 0) {
+            s = go + ADC_ACQ_NS - *switched;
+            if (settle < 0 || s < settle)
+                settle = s;
+            *switched = -1;
+        }
+        now = go + 23 * ADC_TAD_NS;
+        code = Input(chs);
+        ADRESH = code >> 8;
+        ADRESL = code & 0xFF;
+        ADCON0bits.GO = 0;
+        PIR1bits.ADIF = 1;
+        now += ADC_ISR_TCY * TCY_NS;
+        ADCSampleISR();
+        if (ADCON0bits.CHS != chs)
+            *switched = now;
+    }
+    return settle;
+}
+
+// The shortest slot (us) a burst fits in, and within half the CPU
+static long MinSlot(void) {
+    long cpu = (2L * ADC_BURST * ADC_ISR_TCY + CLOCK_TCY_PER_US - 1) / CLOCK_TCY_PER_US;
+    long conv = ADC_BURST_US + 1;
+
+    return cpu > conv ? cpu : conv;
+}
+
+int main(int argc, char **argv) {
+    unsigned char seq[ADC_CHANNELS], last[ADC_CHANNELS];
+    unsigned int stamp[ADC_CHANNELS];
+    long span[ADC_CHANNELS], lo = 1L << 30, hi = 0, settle = -1, s, slot, worst = 0;
+    long switched = -1, k, p, n;
+    unsigned char i, pos;
+    unsigned int st;
+    int v;
+    unsigned char ringSeq, head, want;
+    long ringWait = 0, ringTaken = 0, ringSkipped = 0;
+    static const int sizes[3] = {1, 4, 8};
+
+    if (argc > 1)
+        latency = atol(argv[1]);
+    ADCSampleInit();
+    T3CONbits.TMR3ON = 1;
+    for (i = 0; i < ADC_CHANNELS; i++) {
+        last[i] = ADCRead(i, &v, &st);
+        span[i] = 0;
+    }
+    ringSeq = last[0];
+
+    printf("%lu MHz, %d channels (AN", CLOCK_FOSC / 1000000, ADC_CHANNELS);
+    for (i = 0; i < ADC_CHANNELS; i++)
+        printf("%s%d", i ? " " : "", list[i]);
+    printf("), %d bit samples, ADCON1 0x%02X\n", ADC_BITS, ADCON1);
+    printf("slot %d us, burst %lu us, scan %d us, latency up to %ld us\n\n",
+            ADC_SLOT_US, ADC_BURST_US, ADC_SAMPLE_US, latency);
+
+    srand(1);
+    for (k = 0; k < (long) SCANS * ADC_CHANNELS; k++) {
+        slot = k * ADC_SLOT_US * 1000L;
+        if (now > slot)
+            Error("burst still going at the next overflow", k);
+        now = slot + (latency ? rand() % (latency * 1000) : 0);
+        pos = _vADCpos;
+        PIR2bits.TMR3IF = 1;
+        ADCTimerISR();
+        now += TCY_TIMER * TCY_NS;
+        s = Convert(&switched);
+        if (s >= 0 && (settle < 0 || s < settle))
+            settle = s;
+        if (now - slot > worst)
+            worst = now - slot;
+
+        seq[pos] = ADCRead(pos, &v, &st);
+        if (seq[pos] != (unsigned char) (last[pos] + 1))
+            Error("sequence number skipped", k);
+        if (v != ADCScale(Input(list[pos])))
+            Error("reading from the wrong channel", k);
+        if (k >= ADC_CHANNELS) {
+            p = (unsigned int) (st - stamp[pos]);
+            span[pos] += p;
+            if (p < lo)
+                lo = p;
+            if (p > hi)
+                hi = p;
+        }
+        stamp[pos] = st;
+        last[pos] = seq[pos];
+
+        // the IR ring, taken out at random intervals
+        if (pos == 0 && --ringWait < 0) {
+            head = seq[0];
+            want = ringSeq + 1;
+            if ((unsigned char) (head - ringSeq) > ADC_RING) {
+                ringSkipped += (unsigned char) (head - ringSeq) - ADC_RING;
+                want = head - ADC_RING + 1;
+            }
+            while (ADCNext(&ringSeq, &v)) {
+                if (ringSeq != want++ || v != ADCScale(Input(list[0])))
+                    Error("ADCNext() out of order", k);
+                ringTaken++;
+            }
+            if (ringSeq != head)
+                Error("ADCNext() stopped short", k);
+            ringWait = rand() % (ADC_RING + 3);
+        }
+    }
+    printf("period      %ld - %ld us between samples of a channel\n", lo, hi);
+    if (lo < ADC_SAMPLE_US - latency || hi > ADC_SAMPLE_US + latency)
+        Error("period off by more than the latency", hi);
+    for (i = 0; i < ADC_CHANNELS; i++) {
+        n = span[i] - (long) (SCANS - 1) * ADC_SAMPLE_US;
+        if (n < -latency || n > latency)
+            Error("channel drifted, us", n);
+    }
+    printf("ring        %ld IR samples taken late, %ld lost to overruns\n", ringTaken, ringSkipped);
+    printf("slots       busy %ld us at most out of %d\n", (worst + 999) / 1000, ADC_SLOT_US);
+    if (settle >= 0) {
+        printf("settling    %ld ns at least after a switch, %d needed\n", settle, ADC_TACQ_NS);
+        if (settle < ADC_TACQ_NS)
+            Error("acquisition too short after a switch, ns", settle);
+    } else
+        printf("settling    one channel, never switches\n");
+
+    ADCSlow(1);
+    for (i = 0; i < ADC_CHANNELS; i++)
+        last[i] = ADCRead(i, &v, &st);
+    slot = now;
+    ADCStart();
+    Convert(&switched);
+    for (i = 0; i < ADC_CHANNELS; i++)
+        if (ADCRead(i, &v, &st) != (unsigned char) (last[i] + 1) || v != ADCScale(Input(list[i])))
+            Error("ADCStart() scan missed position", i);
+    if (_vADCpos || ADCBusy())
+        Error("ADCStart() scan didn't end at position 0", _vADCpos);
+    printf("ADCStart()  %d channels in %ld us\n", ADC_CHANNELS, (now - slot + 999) / 1000);
+    ADCSlow(0);
+
+    printf("\nchannels  slot us  CPU  shortest scan us  at %d us\n", ADC_SAMPLE_US);
+    for (i = 0; i < 3; i++) {
+        slot = ADC_SAMPLE_US / sizes[i];
+        n = TCY_TIMER + ADC_BURST * ADC_ISR_TCY + TCY_PUBLISH;
+        printf("%8d %8ld %4.0f%% %17ld  %s\n", sizes[i], slot,
+                n * 100.0 / ClockTcy(slot), sizes[i] * MinSlot(),
+                slot >= MinSlot() ? "fits" : "too short");
+    }
+    printf("\n%d errors\n", errors);
+    return errors != 0;
+}
@@ -0,0 +1,41 @@
+#!/bin/sh
+#*********************************************************************
+# FileName:        examples.sh
+# Processor:       Host (gcc)
+#
+# Builds and runs adcscan with every setting ADC Module.h gives as an
+# example, so a change to the defaults or the #errors that stops one
+# of them building shows up here.  Run from the top of the repo:
+#
+#   sh tools/adcscan/examples.sh
+#
+# Exits 1 if any of them doesn't build or adcscan finds errors in it.
+#*********************************************************************
+
+SRC="MechatronicsProjectOfDoom.X"
+OUT="${TMPDIR:-/tmp}/adcscan-example"
+failed=0
+
+example() {
+    name="$1"
+    shift
+    if ! gcc -Wall -I tools/oversim -I "$SRC" "$@" -o "$OUT" tools/adcscan/adcscan.c "$SRC/ADC Module.c"; then
+        echo "$name: ** doesn't build"
+        failed=1
+    elif ! "$OUT" > /dev/null; then
+        echo "$name: ** adcscan errors"
+        failed=1
+    else
+        echo "$name: ok"
+    fi
+}
+
+example "defaults, IR on AN0"
+example "pot on AN2" -DADC_CHANNELS=2 "-DADC_CHANNEL_LIST=0,2"
+example "4 channels" -DADC_CHANNELS=4 "-DADC_CHANNEL_LIST=0,1,2,4"
+example "8 channels" -DADC_CHANNELS=8 "-DADC_CHANNEL_LIST=0,1,2,3,4,5,6,7" -DADC_SAMPLE_US=2000
+example "oversampling 1 bit" -DADC_OVERSAMPLE_BITS=1
+example "pot on AN2, oversampling 1 bit" -DADC_CHANNELS=2 "-DADC_CHANNEL_LIST=0,2" \
+    -DADC_OVERSAMPLE_BITS=1 -DADC_SAMPLE_US=1200
+rm -f "$OUT"
+exit $failed
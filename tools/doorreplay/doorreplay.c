@@ -0,0 +1,411 @@
+/*********************************************************************
+ * FileName:        doorreplay.c
+ * Processor:       Host (gcc)
+ *
+ * Plays ADC traces through Door Module.c, the control loop the PIC
+ * runs (median filter, IR Module, events, Lock Module), at simulated
+ * time, and records every transition of its outputs with the time it
+ * happened: RA1 through DoorBeamOut() and the bolt through LockBolt().
+ *
+ *   gcc -O2 -Wall -I MechatronicsProjectOfDoom.X -o doorreplay \
+ *       tools/doorreplay/doorreplay.c "MechatronicsProjectOfDoom.X/Door Module.c" \
+ *       "MechatronicsProjectOfDoom.X/IR Module.c" "MechatronicsProjectOfDoom.X/Filter Module.c" \
+ *       "MechatronicsProjectOfDoom.X/Lock Module.c" "MechatronicsProjectOfDoom.X/Event Module.c"
+ *   ./doorreplay trace         one trace, every transition printed
+ *   ./doorreplay [-n N]        N synthetic traces (2000 by default)
+ *   ./doorreplay -d K          writes synthetic trace K out as a trace file
+ *   ./doorreplay -t T ...      taskSample() only gets round every T ms
+ *
+ * Time moves on 1 ms at a time, the scheduler tick, in the order the
+ * tasks run on the PIC: card swipes and codes due are posted (EVQ_HIGH
+ * like KeyISR(), EVQ_MAIN like taskButtons()), every sample published
+ * since the last run goes to DoorSample() in order, like taskSample()
+ * draining ADCNext(), then DoorDetect(), DoorRun(), and LockTick()
+ * every LOCK_TICK_MS at phase 7.  Sample k is published k x
+ * ADC_SAMPLE_US in.  Low power sampling is the main file's and isn't
+ * modelled.
+ *
+ * Before the synthetic traces it plays a rise cut short by a one
+ * sample dip with taskSample() running every 2 ms, at both offsets, so
+ * the dip is the older of the two samples a run drains at one of them.
+ * The detector has to see it and drop the candidate.
+ *
+ * A trace is what irreplay reads, one 10 bit reading per line with an
+ * optional 0/1 saying whether something really was in the beam, plus
+ * lines card, badcard or code, posted at the time of the next reading.
+ * Lines starting with # are skipped.
+ *
+ * Each synthetic trace is quiet background with single sample spikes,
+ * a card swipe half the time, then either a glitch under IR_DWELL_MS
+ * that must not trigger or someone in the beam for 0.4 - 2.5 s, then
+ * enough quiet for the lock to close again.  Each one checks that the
+ * beam was found, within LATENCY_MAX_MS, with no false triggers, that
+ * a swipe opens the bolt in the same ms, that the lock only moves for
+ * a swipe and that it ends up LOCKED with the bolt stopped.  Exits 1 on
+ * any failure, so a change that slows detection down or breaks the
+ * lock shows up here before it gets to a board.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Door Module.h"
+
+#define MAX_SAMPLES     200000L
+#define MAX_POSTS       256
+
+#define EDGE_SAMPLES    40      // beam edge, under IR_EXIT, before the reading is up
+#ifndef LATENCY_MAX_MS
+#define LATENCY_MAX_MS  ((EDGE_SAMPLES + IR_DWELL_SAMPLES + 3L) * ADC_SAMPLE_US / 1000 + 2)
+#endif
+
+#define Samples(ms)     ((long) (ms) * 1000L / ADC_SAMPLE_US)
+
+// Trace
+static int value[MAX_SAMPLES];
+static char truth[MAX_SAMPLES];
+static char labelled;
+static long n;
+static long postAt[MAX_POSTS]; // sample index
+static unsigned char postEvent[MAX_POSTS];
+static int posts;
+static char kind; // synthetic: 0 glitch, 1 someone in the beam
+
+// Outputs
+static char logAll; // print each transition as it happens
+static long now; // ms
+static unsigned char ra1, bolt;
+static char ra1Set; // RA1 went on at some point
+static long boltMoves;
+static long sampleEvery = 1; // ms between taskSample() runs
+
+static const char *moves[] = {"stop", "open", "close"};
+static const char *states[LOCK_STATES] = {"LOCKED", "UNLOCKING", "UNLOCKED", "OPEN", "LOCKING"};
+
+typedef struct {
+    long traces, samples, ms;
+    long events, found, missed, falseTriggers;
+    double latency, latencyMax;
+    long swipes, boltLatMax, lockErrors;
+    double seconds;
+} Result_t;
+
+static Result_t total;
+static int failures;
+
+void DoorBeamOut(char on) {
+    if ((unsigned char) on != ra1) {
+        ra1 = on;
+        if (on)
+            ra1Set = 1;
+        if (logAll)
+            printf("%8ld  RA1  %d\n", now, ra1);
+    }
+}
+
+void LockBolt(unsigned char move) {
+    if (move != bolt) {
+        bolt = move;
+        boltMoves++;
+        if (logAll)
+            printf("%8ld  bolt %s\n", now, moves[bolt]);
+    }
+}
+
+/** Traces *********************************************************/
+
+static unsigned long seed;
+
+static long Random(long range) {
+    seed = seed * 1103515245UL + 12345UL;
+    return (long) ((seed >> 16) & 0x7FFF) * range >> 15;
+}
+
+static void Add(long count, int level, int amplitude, char present) {
+    while (count-- > 0 && n < MAX_SAMPLES) {
+        value[n] = Random(500) ? level + (int) Random(2 * amplitude + 1) - amplitude : 1023;
+        truth[n++] = present;
+    }
+}
+
+static void Post(unsigned char event) {
+    if (posts < MAX_POSTS) {
+        postAt[posts] = n;
+        postEvent[posts++] = event;
+    }
+}
+
+static void Synth(long k) {
+    seed = (unsigned long) k * 2654435761UL + 1;
+    n = 0;
+    posts = 0;
+    labelled = 1;
+    Add(Samples(300), 820, 6, 0);
+    if (Random(2))
+        Post(EV_KEY_VALID);
+    Add(Samples(1000 + Random(1000)), 820, 6, 0); // bolt open before anyone gets there
+    kind = Random(4) != 0;
+    if (kind) {
+        Add(EDGE_SAMPLES, 900, 50, 1);
+        Add(Samples(400 + Random(2100)), 1020, 8, 1);
+    } else
+        Add(1 + Random(IR_DWELL_SAMPLES / 3), 1012, 3, 0);
+    Add(Samples(posts ? LOCK_WAIT_MS + LOCK_BOLT_MS + 1000 : 1000), 820, 6, 0);
+}
+
+static void Dump(long k) {
+    static const char *names[EV_COUNT] = {"", "card", "badcard", "code"};
+    long i;
+    int p = 0;
+
+    Synth(k);
+    printf("# synthetic trace %ld, %s, %s\n", k, kind ? "someone in the beam" : "glitch",
+            posts ? "card" : "no card");
+    for (i = 0; i < n; i++) {
+        while (p < posts && postAt[p] == i)
+            printf("%s\n", names[postEvent[p++]]);
+        printf("%d %d\n", value[i], truth[i]);
+    }
+}
+
+static void Load(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[80], word[16];
+    int v, t;
+
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    labelled = 1;
+    while (n < MAX_SAMPLES && fgets(line, sizeof(line), f)) {
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%15[a-z]", word) == 1) {
+            if (!strcmp(word, "card"))
+                Post(EV_KEY_VALID);
+            else if (!strcmp(word, "badcard"))
+                Post(EV_KEY_INVALID);
+            else if (!strcmp(word, "code"))
+                Post(EV_CODE);
+            else
+                fprintf(stderr, "%s: %s? skipped\n", path, word);
+            continue;
+        }
+        t = -1;
+        if (sscanf(line, "%d%*[ ,\t]%d", &v, &t) < 1)
+            continue;
+        if (t < 0)
+            labelled = 0;
+        value[n] = v;
+        truth[n++] = (t > 0);
+    }
+    fclose(f);
+}
+
+static void Level(long count, int level) {
+    while (count-- > 0 && n < MAX_SAMPLES) {
+        value[n] = level;
+        truth[n++] = 0;
+    }
+}
+
+// Quiet, half a dwell up, a dip the median of 3 passes as one sample
+// (up up down up down up up), three quarters of a dwell up, quiet
+static void Dip(long offset) {
+    n = 0;
+    posts = 0;
+    labelled = 0;
+    kind = 0;
+    Level(Samples(300) + offset, 820);
+    Level(IR_DWELL_SAMPLES / 2, 1020);
+    Level(1, 820);
+    Level(1, 1020);
+    Level(1, 820);
+    Level(IR_DWELL_SAMPLES * 3 / 4, 1020);
+    Level(Samples(500), 820);
+}
+
+/** Replay *********************************************************/
+
+static void Fail(long k, const char *what, long v) {
+    if (failures++ < 10)
+        printf("  ** trace %ld: %s (%ld)\n", k, what, v);
+}
+
+// Runs the loaded trace, scores it into r, returns the number of checks failed
+static int Play(Result_t *r, long k) {
+    long end = n * ADC_SAMPLE_US / 1000 + 1, i = -1, next = 0, start = -1, swipe = -1;
+    long boltLat = -1;
+    int p = 0, before = failures;
+    char claimed = 0, last = 0, sawOpen = 0, present;
+
+    ra1 = 1; // DoorInit() sets RA1, and LockInit() the bolt, which logs both
+    bolt = 0xFF;
+    boltMoves = -1;
+    now = 0;
+    DoorInit();
+    ra1Set = 0;
+    for (now = 0; now < end; now++) {
+        while (p < posts && postAt[p] * ADC_SAMPLE_US <= now * 1000L) {
+            EventPost(postEvent[p] == EV_CODE ? EVQ_MAIN : EVQ_HIGH, postEvent[p]);
+            if (postEvent[p++] == EV_KEY_VALID && swipe < 0)
+                swipe = now;
+            r->swipes++;
+        }
+        while (next < n && next * ADC_SAMPLE_US <= now * 1000L)
+            next++;
+        if (now % sampleEvery == 0)
+            while (i < next - 1) {
+                i++;
+                DoorSample(ADCScale(value[i]), (unsigned char) (i + 1));
+            }
+        DoorDetect();
+        DoorRun();
+        if (now % LOCK_TICK_MS == 7)
+            LockTick();
+        if (swipe >= 0 && boltLat < 0 && bolt == LOCK_BOLT_OPEN)
+            boltLat = now - swipe;
+        if (LockState() == LOCK_OPEN)
+            sawOpen = 1;
+
+        // Score RA1 against the truth of the sample it has seen
+        if (i < 0 || !labelled)
+            continue;
+        present = truth[i];
+        if (present && start < 0) {
+            r->events++;
+            start = now;
+            claimed = 0;
+        }
+        if (!present && start >= 0) {
+            if (!claimed) {
+                r->missed++;
+                Fail(k, "beam missed, ms in", start);
+            }
+            start = -1;
+        }
+        if (ra1 && !last) {
+            if (start >= 0 && !claimed) {
+                double lat = now - start;
+                r->found++;
+                r->latency += lat;
+                if (lat > r->latencyMax)
+                    r->latencyMax = lat;
+                if (lat > LATENCY_MAX_MS)
+                    Fail(k, "detected late, ms", (long) lat);
+                claimed = 1;
+            } else {
+                r->falseTriggers++;
+                Fail(k, "false trigger, ms in", now);
+            }
+        }
+        last = ra1;
+    }
+    if (start >= 0 && !claimed) {
+        r->missed++;
+        Fail(k, "beam missed at the end, ms in", start);
+    }
+    if (swipe >= 0) {
+        if (boltLat < 0 || boltLat > 1)
+            Fail(k, "bolt didn't open in the ms of the swipe", boltLat);
+        if (boltLat > r->boltLatMax)
+            r->boltLatMax = boltLat;
+        if (kind && !sawOpen && k >= 0)
+            Fail(k, "never OPEN with someone in the beam", 0);
+    } else if (boltMoves && k >= 0)
+        Fail(k, "bolt moved without a swipe", boltMoves);
+    if (k >= 0 && (LockState() != LOCK_LOCKED || bolt != LOCK_BOLT_STOP)) {
+        r->lockErrors++;
+        Fail(k, "didn't end LOCKED and stopped, state", LockState());
+    }
+    r->traces++;
+    r->samples += n;
+    r->ms += end;
+    return failures - before;
+}
+
+// Dip() with two samples a taskSample() run, the dip first and second of the pair
+static void Dips(void) {
+    Result_t r;
+    long offset, every = sampleEvery;
+
+    sampleEvery = 2;
+    for (offset = 0; offset < 2; offset++) {
+        memset(&r, 0, sizeof(r));
+        Dip(offset);
+        Play(&r, -1);
+        printf("dip, 2 a run, offset %ld  %s, %u candidates dropped  %s\n", offset,
+                ra1Set ? "detected" : "clear", IRDetectRejects, !ra1Set && IRDetectRejects == 2 ? "ok" : "** wrong");
+        if (ra1Set || IRDetectRejects != 2)
+            failures++;
+    }
+    sampleEvery = every;
+}
+
+static void Print(const Result_t *r) {
+    if (r->events) {
+        printf("beam        %ld events, %ld found, %ld missed, %ld false triggers\n",
+                r->events, r->found, r->missed, r->falseTriggers);
+        if (r->found)
+            printf("latency     %.1f ms mean, %.0f ms worst, %ld allowed\n",
+                    r->latency / r->found, r->latencyMax, (long) LATENCY_MAX_MS);
+    }
+    if (r->swipes)
+        printf("swipes      %ld cards and codes, bolt moving %ld ms after at worst\n", r->swipes, r->boltLatMax);
+}
+
+int main(int argc, char **argv) {
+    Result_t r;
+    long count = 2000, k, first = -1;
+    clock_t start;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            count = atol(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            sampleEvery = atol(argv[++i]) > 0 ? atol(argv[i]) : 1;
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc) {
+            Dump(atol(argv[++i]));
+            return 0;
+        } else {
+            memset(&r, 0, sizeof(r));
+            Load(argv[i]);
+            printf("%ld samples (%.1f s), %d posts, enter %d, exit %d, dwell %d ms\n\n",
+                    n, n * ADC_SAMPLE_US / 1e6, posts, IR_ENTER, IR_EXIT, IR_DWELL_MS);
+            printf("%8s  output\n", "ms");
+            logAll = 1;
+            kind = 0;
+            Play(&r, -1);
+            printf("\nends %s, %u candidates dropped before the dwell ran out\n",
+                    states[LockState()], IRDetectRejects);
+            if (labelled)
+                Print(&r);
+            return 0;
+        }
+    }
+
+    Dips();
+    printf("\n%ld synthetic traces, enter %d, exit %d, dwell %d ms, sample %d us, taskSample() every %ld ms\n\n",
+            count, IR_ENTER, IR_EXIT, IR_DWELL_MS, ADC_SAMPLE_US, sampleEvery);
+    memset(&total, 0, sizeof(total));
+    for (k = 0; k < count; k++) {
+        Synth(k);
+        start = clock();
+        if (Play(&total, k) && first < 0)
+            first = k;
+        total.seconds += (double) (clock() - start) / CLOCKS_PER_SEC;
+    }
+    Print(&total);
+    printf("lock        %ld traces not LOCKED at the end\n", total.lockErrors);
+    if (total.seconds > 0)
+        printf("\nreplay      %.0f traces/s, %.1f simulated s per s, %.2f Msamples/s\n",
+                total.traces / total.seconds, total.ms / 1000.0 / total.seconds,
+                total.samples / total.seconds / 1e6);
+    if (first >= 0)
+        printf("\n-d %ld writes the first failing trace out\n", first);
+    printf("\n%d errors\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,236 @@
+/*********************************************************************
+ * FileName:        filtercheck.c
+ * Processor:       Host (gcc)
+ *
+ * Runs each Filter Module.c filter against a floating point reference
+ * on the same input and checks:
+ *
+ *   FilterAvg   the mean of the last FILTER_AVG_TAPS readings, rounded
+ *               down, exactly
+ *   FilterIIR   within 1 LSB of y += (x - y) / 2^shift for every shift
+ *               from 1 to FILTER_IIR_MAXSHIFT, and settled on a steady
+ *               input exactly, 0 and ADC_MAX included
+ *   FilterMed3  the median of the last 3 and 5 readings, exactly
+ *   FilterMed5
+ *
+ * on random readings, noisy steps, single and double sample spikes,
+ * and the ends of the range.  Then it prints an estimate of each
+ * filter's instruction cycles on the PIC, best and worst case (the
+ * medians' swaps), from the swap counts seen.
+ *
+ *   gcc -Wall -I MechatronicsProjectOfDoom.X -o filtercheck \
+ *       tools/filtercheck/filtercheck.c "MechatronicsProjectOfDoom.X/Filter Module.c"
+ *   ./filtercheck
+ *
+ * -DADC_OVERSAMPLE_BITS=... and -DFILTER_AVG_SHIFT=... try other
+ * widths, the same as on the PIC (3 bits needs -DADC_SAMPLE_US=10000
+ * to get past the ADC Module.h #errors).  The cycles are estimates,
+ * the MPLAB SIM stopwatch has the real ones.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Filter Module.h"
+
+#define SAMPLES         100000L
+
+// Estimated instruction cycles, C18 with the state behind a pointer
+#define TCY_CALL        14      // call, return, two arguments on the software stack
+#define TCY_AVG         48      // sum update, tap store, index wrap, shift out
+#define TCY_IIR         26      // add and subtract, without the shifts
+#define TCY_SHIFT       4       // each bit of a 16 bit shift, the IIR does two
+#define TCY_COPY        8       // each tap into a local
+#define TCY_TAPS        18      // store the new reading, move the index on
+#define TCY_COMPARE     6       // a signed 16 bit compare
+#define TCY_SWAP        9       // the three moves when it is out of order
+
+static int input[SAMPLES];
+static int errors;
+static unsigned long seed = 1;
+
+static int Random(int n) {
+    seed = seed * 1103515245UL + 12345UL;
+    return (int) ((seed >> 16) % (unsigned long) n);
+}
+
+static int Clip(int x) {
+    return x < 0 ? 0 : x > ADC_MAX ? ADC_MAX : x;
+}
+
+// Random readings, noisy steps between random levels, spikes, and the ends of the range
+static void Make(void) {
+    long i = 0;
+    int level, n, k;
+
+    while (i < SAMPLES) {
+        level = Random(ADC_MAX + 1);
+        n = 20 + Random(200);
+        switch (Random(5)) {
+            case 0: // plain random
+                for (k = 0; k < n && i < SAMPLES; k++)
+                    input[i++] = Random(ADC_MAX + 1);
+                break;
+            case 1: // one or two sample spikes on a steady level
+                for (k = 0; k < n && i < SAMPLES; k++)
+                    input[i++] = Random(20) ? level : Random(2) ? ADC_MAX : 0;
+                break;
+            case 2: // the ends
+                for (k = 0; k < n && i < SAMPLES; k++)
+                    input[i++] = (k / 37) & 1 ? ADC_MAX : 0;
+                break;
+            default: // noisy level
+                for (k = 0; k < n && i < SAMPLES; k++)
+                    input[i++] = Clip(level + Random(41) - 20);
+                break;
+        }
+    }
+}
+
+static void Error(const char *what, long i, int got, double want) {
+    if (errors++ < 10)
+        printf("  ** %s at %ld: %d, reference %.3f\n", what, i, got, want);
+}
+
+static int Compare(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return x < y ? -1 : x > y;
+}
+
+// Median of the n readings up to i, the window starts full of seed
+static double Median(long i, int n, int seed) {
+    double w[5];
+    int k;
+
+    for (k = 0; k < n; k++)
+        w[k] = i - k >= 0 ? input[i - k] : seed;
+    qsort(w, n, sizeof w[0], Compare);
+    return w[n / 2];
+}
+
+// Swaps the network in Filter Module.c makes on the window up to i
+static int Swaps(long i, int n) {
+    int p[5], k, t, s = 0;
+    static const unsigned char net3[3][2] = {{0, 1}, {1, 2}, {0, 1}};
+    static const unsigned char net5[7][2] = {{0, 1}, {3, 4}, {0, 3}, {1, 4}, {1, 2}, {2, 3}, {1, 2}};
+    const unsigned char (*net)[2] = n == 3 ? net3 : net5;
+
+    // taps in the filter's own order, the oldest slot first after the wrap
+    for (k = 0; k < n; k++)
+        p[(i - k) % n >= 0 ? (i - k) % n : (i - k) % n + n] = i - k >= 0 ? input[i - k] : 0;
+    for (k = 0; k < (n == 3 ? 3 : 7); k++)
+        if (p[net[k][0]] > p[net[k][1]]) {
+            t = p[net[k][0]];
+            p[net[k][0]] = p[net[k][1]];
+            p[net[k][1]] = t;
+            s++;
+        }
+    return s;
+}
+
+static void CheckAvg(void) {
+    FilterAvg_t f;
+    double sum = 0;
+    long i;
+    int y;
+
+    FilterAvgInit(&f, 0);
+    for (i = 0; i < SAMPLES; i++) {
+        sum += input[i] - (i >= FILTER_AVG_TAPS ? input[i - FILTER_AVG_TAPS] : 0);
+        y = FilterAvg(&f, input[i]);
+        if (y != (int) (sum / FILTER_AVG_TAPS))
+            Error("FilterAvg", i, y, sum / FILTER_AVG_TAPS);
+    }
+    printf("FilterAvg   %d taps, exact\n", FILTER_AVG_TAPS);
+}
+
+static void CheckIIR(void) {
+    FilterIIR_t f;
+    double ref, diff, worst;
+    unsigned char shift;
+    long i;
+    int y, level, k;
+
+    for (shift = 1; shift <= FILTER_IIR_MAXSHIFT; shift++) {
+        FilterIIRInit(&f, shift, 0);
+        ref = 0;
+        worst = 0;
+        for (i = 0; i < SAMPLES; i++) {
+            ref += (input[i] - ref) / (1 << shift);
+            y = FilterIIR(&f, input[i]);
+            diff = y - ref;
+            if (diff < 0)
+                diff = -diff;
+            if (diff > worst)
+                worst = diff;
+            if (diff > 1.0)
+                Error("FilterIIR more than 1 LSB out", i, y, ref);
+        }
+        // steady input, from the far end of the range
+        for (k = 0; k < 3; k++) {
+            level = k == 0 ? ADC_MAX : k == 1 ? 0 : ADC_MAX / 3;
+            FilterIIRInit(&f, shift, ADC_MAX - level);
+            for (i = 0; i < (40L << shift); i++)
+                y = FilterIIR(&f, level);
+            if (y != level)
+                Error("FilterIIR didn't settle", level, y, level);
+        }
+        printf("FilterIIR   shift %d, %.3f LSB at most, settles exactly\n", shift, worst);
+    }
+}
+
+static void CheckMed(int n, int *lo, int *hi) {
+    FilterMed3_t f3;
+    FilterMed5_t f5;
+    long i;
+    int y, s;
+
+    FilterMed3Init(&f3, 0);
+    FilterMed5Init(&f5, 0);
+    *lo = 7;
+    *hi = 0;
+    for (i = 0; i < SAMPLES; i++) {
+        y = n == 3 ? FilterMed3(&f3, input[i]) : FilterMed5(&f5, input[i]);
+        if (y != Median(i, n, 0))
+            Error(n == 3 ? "FilterMed3" : "FilterMed5", i, y, Median(i, n, 0));
+        s = Swaps(i, n);
+        if (s < *lo)
+            *lo = s;
+        if (s > *hi)
+            *hi = s;
+    }
+    printf("FilterMed%d  exact, %d - %d swaps a call\n", n, *lo, *hi);
+}
+
+static void Cycles(const char *name, long best, long worst) {
+    best += TCY_CALL;
+    worst += TCY_CALL;
+    printf("%-22s %5ld %5ld   %5.1f us\n", name, best, worst, (double) worst / CLOCK_TCY_PER_US);
+}
+
+int main(void) {
+    int lo3, hi3, lo5, hi5;
+    char name[32];
+    unsigned char shift;
+
+    printf("%ld samples, %d bits, 0 - %d\n\n", SAMPLES, ADC_BITS, ADC_MAX);
+    Make();
+    CheckAvg();
+    CheckIIR();
+    CheckMed(3, &lo3, &hi3);
+    CheckMed(5, &lo5, &hi5);
+
+    printf("\ncycles (estimated)      best worst   at %lu MHz\n", CLOCK_FOSC / 1000000);
+    Cycles("FilterAvg", TCY_AVG, TCY_AVG);
+    for (shift = 2; shift <= FILTER_IIR_MAXSHIFT; shift += 2) {
+        sprintf(name, "FilterIIR shift %d", shift);
+        Cycles(name, TCY_IIR + 2 * shift * TCY_SHIFT, TCY_IIR + 2 * shift * TCY_SHIFT);
+    }
+    Cycles("FilterMed3", TCY_TAPS + 3 * TCY_COPY + 3 * TCY_COMPARE + lo3 * TCY_SWAP,
+            TCY_TAPS + 3 * TCY_COPY + 3 * TCY_COMPARE + 3 * TCY_SWAP);
+    Cycles("FilterMed5", TCY_TAPS + 5 * TCY_COPY + 7 * TCY_COMPARE + lo5 * TCY_SWAP,
+            TCY_TAPS + 5 * TCY_COPY + 7 * TCY_COMPARE + 7 * TCY_SWAP);
+
+    printf("\n%d errors\n", errors);
+    return errors != 0;
+}
@@ -0,0 +1,241 @@
+/*********************************************************************
+ * FileName:        fmtcheck.c
+ * Processor:       Host (gcc)
+ *
+ * Checks LCD Format.c against printf, through XLCDFmtToBuf():
+ *
+ *   XLCDFmtUDec    "%*u" and "%0*u", every value 0 - 65535 at width 0,
+ *                  and the edges at every width and pad
+ *   XLCDFmtDec     "%*d" and "%0*d", every value -32768 - 32767 the
+ *                  same way
+ *   XLCDFmtFixed   "%*.*f" and "%0*.*f" of value / 10^decimals, 0 - 4
+ *                  decimals, -5 with 2 is "-0.05"
+ *   XLCDFmtHex     "%0*X" of the low digits, 1 - 4 of them
+ *   XLCDFmtToBuf   cut off at size - 1 and NUL terminated as snprintf(),
+ *                  and fields appended one after the other
+ *
+ * Then it prints an estimate of the instruction cycles a field takes
+ * on the PIC, from the subtracts and characters seen, next to
+ * sprintf() doing the same, and of the program memory each pulls in.
+ *
+ *   gcc -Wall -I tools/lcdsim -I MechatronicsProjectOfDoom.X -o fmtcheck \
+ *       tools/fmtcheck/fmtcheck.c "MechatronicsProjectOfDoom.X/LCD Format.c"
+ *   ./fmtcheck
+ *
+ * The cycles and words are estimates, the MPLAB SIM stopwatch and the
+ * .map file have the real ones.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "LCD Format.h"
+
+// Estimated instruction cycles, C18
+#define TCY_CALL        20      // call, return, the arguments on the software stack
+#define TCY_DIGIT       22      // each of the five powers of ten: table read, loop set up
+#define TCY_SUBTRACT    14      // each subtract: 16 bit compare, subtract, digit++
+#define TCY_LEADING     40      // finding the first digit, the width sums
+#define TCY_EMIT        30      // XLCDFmtEmit() a character into the buffer
+#define TCY_SPRINTF     350     // sprintf() parsing "%5u", varargs, the NUL
+#define TCY_SPRINTF_DIGIT 400   // each digit: a 16 bit divide and modulo by 10
+#define TCY_SPRINTF_CHAR 25     // each character stored
+
+// Estimated program words
+#define WORDS_FMT       520     // all of LCD Format.c with its tables
+#define WORDS_SPRINTF   2000    // sprintf() and what it links in, lcdbench.c has the same
+
+static int errors;
+static int cases;
+
+// Output is only ever a buffer here
+void XLCDPut(char data) {
+    (void) data;
+}
+
+void XLCDBufPut(unsigned char row, unsigned char col, char c) {
+    (void) row;
+    (void) col;
+    (void) c;
+}
+
+static void Compare(const char *what, long value, int width, char pad, const char *got,
+        const char *want) {
+    cases++;
+    if (strcmp(got, want) && errors++ < 20)
+        printf("  ** %s %ld width %d pad '%c': [%s], printf [%s]\n", what, value, width, pad, got, want);
+}
+
+static const unsigned int uvalues[] = {
+    0, 1, 9, 10, 99, 100, 999, 1000, 9999, 10000, 12345, 32767, 32768, 65534, 65535
+};
+static const int svalues[] = {
+    -32768, -32767, -10000, -9999, -1000, -999, -100, -99, -10, -9, -5, -1,
+    0, 1, 5, 9, 10, 99, 100, 999, 1000, 9999, 10000, 32767
+};
+static const unsigned int hexValues[] = {0, 1, 0xF, 0x10, 0xABC, 0x1234, 0xBEEF, 0xFFFF};
+static const unsigned char widths[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 10};
+static const char pads[] = {' ', '0'};
+
+#define N(a) (int) (sizeof(a) / sizeof((a)[0]))
+
+static void CheckUDec(void) {
+    char got[16], want[16];
+    long v;
+    int i, w, p;
+
+    for (v = 0; v <= 65535; v++) {
+        XLCDFmtToBuf(got, sizeof got);
+        XLCDFmtUDec((unsigned int) v, 0, ' ');
+        sprintf(want, "%lu", (unsigned long) v);
+        Compare("XLCDFmtUDec", v, 0, ' ', got, want);
+    }
+    for (i = 0; i < N(uvalues); i++)
+        for (w = 0; w < N(widths); w++)
+            for (p = 0; p < N(pads); p++) {
+                XLCDFmtToBuf(got, sizeof got);
+                XLCDFmtUDec(uvalues[i], widths[w], pads[p]);
+                sprintf(want, pads[p] == '0' ? "%0*u" : "%*u", widths[w], uvalues[i]);
+                Compare("XLCDFmtUDec", uvalues[i], widths[w], pads[p], got, want);
+            }
+}
+
+static void CheckDec(void) {
+    char got[16], want[16];
+    long v;
+    int i, w, p;
+
+    for (v = -32768; v <= 32767; v++) {
+        XLCDFmtToBuf(got, sizeof got);
+        XLCDFmtDec((int) v, 0, ' ');
+        sprintf(want, "%ld", v);
+        Compare("XLCDFmtDec", v, 0, ' ', got, want);
+    }
+    for (i = 0; i < N(svalues); i++)
+        for (w = 0; w < N(widths); w++)
+            for (p = 0; p < N(pads); p++) {
+                XLCDFmtToBuf(got, sizeof got);
+                XLCDFmtDec(svalues[i], widths[w], pads[p]);
+                sprintf(want, pads[p] == '0' ? "%0*d" : "%*d", widths[w], svalues[i]);
+                Compare("XLCDFmtDec", svalues[i], widths[w], pads[p], got, want);
+            }
+}
+
+static void CheckFixed(void) {
+    static const double scale[5] = {1, 10, 100, 1000, 10000};
+    char got[16], want[16], what[24];
+    int i, d, w, p;
+
+    for (d = 0; d <= 4; d++) {
+        sprintf(what, "XLCDFmtFixed %d dp", d);
+        for (i = 0; i < N(svalues); i++)
+            for (w = 0; w < N(widths); w++)
+                for (p = 0; p < N(pads); p++) {
+                    XLCDFmtToBuf(got, sizeof got);
+                    XLCDFmtFixed(svalues[i], (unsigned char) d, widths[w], pads[p]);
+                    sprintf(want, pads[p] == '0' ? "%0*.*f" : "%*.*f", widths[w], d,
+                            svalues[i] / scale[d]);
+                    Compare(what, svalues[i], widths[w], pads[p], got, want);
+                }
+    }
+}
+
+static void CheckHex(void) {
+    char got[16], want[16];
+    int i, d;
+
+    for (i = 0; i < N(hexValues); i++)
+        for (d = 1; d <= 4; d++) {
+            XLCDFmtToBuf(got, sizeof got);
+            XLCDFmtHex(hexValues[i], (unsigned char) d);
+            sprintf(want, "%0*X", d, hexValues[i] & (0xFFFFu >> (16 - 4 * d)));
+            Compare("XLCDFmtHex", hexValues[i], d, '0', got, want);
+        }
+}
+
+static void CheckBuf(void) {
+    char got[16], want[16];
+    unsigned char size;
+
+    for (size = 1; size <= 12; size++) {
+        memset(got, 'x', sizeof got);
+        XLCDFmtToBuf(got, size);
+        XLCDFmtDec(-1234, 7, '0');
+        XLCDFmtHex(0xBEEF, 4);
+        snprintf(want, size, "%07d%04X", -1234, 0xBEEF);
+        Compare("XLCDFmtToBuf size", size, 7, '0', got, want);
+        if (got[size] != 'x' && errors++ < 20)
+            printf("  ** XLCDFmtToBuf size %u wrote past the end\n", size);
+        if (XLCDFmtCount() != (unsigned char) strlen(got) && errors++ < 20)
+            printf("  ** XLCDFmtCount() %u for [%s]\n", XLCDFmtCount(), got);
+    }
+}
+
+// Subtracts XLCDFmtNum() makes for value: the sum of its digits
+static int Subtracts(unsigned int value) {
+    int s = 0;
+
+    while (value) {
+        s += value % 10;
+        value /= 10;
+    }
+    return s;
+}
+
+static int Digits(unsigned int value) {
+    int n = 1;
+
+    while (value >= 10) {
+        value /= 10;
+        n++;
+    }
+    return n;
+}
+
+static long FmtCycles(unsigned int value, int chars) {
+    return TCY_CALL + 5 * TCY_DIGIT + TCY_LEADING + Subtracts(value) * TCY_SUBTRACT + chars * TCY_EMIT;
+}
+
+static long SprintfCycles(unsigned int value, int chars) {
+    return TCY_CALL + TCY_SPRINTF + Digits(value) * TCY_SPRINTF_DIGIT + chars * TCY_SPRINTF_CHAR;
+}
+
+static void Cycles(void) {
+    long fmt, spr, fmtBest = 1L << 30, fmtWorst = 0, sprBest = 1L << 30, sprWorst = 0;
+    double fmtSum = 0, sprSum = 0;
+    long v;
+
+    // XLCDFmtUDec(v, 5, ' ') against sprintf(buf, "%5u", v)
+    for (v = 0; v <= 65535; v++) {
+        fmt = FmtCycles((unsigned int) v, 5);
+        spr = SprintfCycles((unsigned int) v, 5);
+        fmtSum += fmt;
+        sprSum += spr;
+        if (fmt < fmtBest)
+            fmtBest = fmt;
+        if (fmt > fmtWorst)
+            fmtWorst = fmt;
+        if (spr < sprBest)
+            sprBest = spr;
+        if (spr > sprWorst)
+            sprWorst = spr;
+    }
+    printf("\n5 wide unsigned, 0 - 65535 (estimated)\n");
+    printf("%-22s %6s %6s %6s   %s\n", "", "best", "mean", "worst", "words");
+    printf("%-22s %6ld %6.0f %6ld   %5d\n", "XLCDFmtUDec", fmtBest, fmtSum / 65536, fmtWorst, WORDS_FMT);
+    printf("%-22s %6ld %6.0f %6ld   %5d\n", "sprintf \"%5u\"", sprBest, sprSum / 65536, sprWorst,
+            WORDS_SPRINTF);
+    printf("worst case %.0f us against %.0f us at %lu MHz\n", (double) fmtWorst / CLOCK_TCY_PER_US,
+            (double) sprWorst / CLOCK_TCY_PER_US, CLOCK_FOSC / 1000000);
+}
+
+int main(void) {
+    CheckUDec();
+    CheckDec();
+    CheckFixed();
+    CheckHex();
+    CheckBuf();
+    printf("%d cases against printf\n", cases);
+    Cycles();
+    printf("\n%d errors\n", errors);
+    return errors != 0;
+}
@@ -0,0 +1,198 @@
+/*********************************************************************
+ * FileName:        irreplay.c
+ * Processor:       Host (gcc)
+ *
+ * Plays an ADC trace through IR Module.c and through the old main
+ * loop (wait 300 ms on anything over 1000, then latch the stale
+ * reading against 1005) and compares the two.
+ *
+ *   gcc -Wall -I MechatronicsProjectOfDoom.X -o irreplay \
+ *       tools/irreplay/irreplay.c "MechatronicsProjectOfDoom.X/IR Module.c"
+ *   ./irreplay [trace]
+ *
+ * Thresholds and dwell times can be tried out with -DIR_ENTER=...,
+ * -DIR_DWELL_MS=... and so on, same as on the PIC.
+ *
+ * A trace has one 10 bit reading per line (what telemcap writes),
+ * ADC_SAMPLE_US apart, scaled up to ADC_BITS for IR Module, optionally
+ * followed by a 0/1 saying whether something really was in the beam.
+ * Lines starting with # are skipped.  Without a file a built in trace
+ * is used: noise, short glitches, a reading sitting on the threshold
+ * and some real events.
+ *
+ * The old loop ran one conversion per pass, which is modelled here as
+ * one pass per sample; the 300 ms it spends in Delay10KTCYx(30) is
+ * reported as time the loop was frozen.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "IR Module.h"
+
+#define MAX_SAMPLES 200000L
+
+static int value[MAX_SAMPLES];
+static char truth[MAX_SAMPLES];
+static char labelled;
+static long n;
+
+typedef struct {
+    const char *name;
+    long events, found, missed, falseTriggers, frozen;
+    double latency, latencyMax, release;
+    long releases;
+} Result_t;
+
+static unsigned long seed = 1;
+
+static int Noise(int amplitude) {
+    seed = seed * 1103515245UL + 12345UL;
+    return (int) ((seed >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+static void Add(long count, int level, int amplitude, char present) {
+    while (count-- > 0 && n < MAX_SAMPLES) {
+        value[n] = level + Noise(amplitude);
+        truth[n++] = present;
+    }
+}
+
+static void BuiltIn(void) {
+    int i;
+
+    labelled = 1;
+    Add(500, 820, 6, 0);
+    for (i = 0; i < 8; i++) { // glitches of 1 to 128 samples
+        Add(1 << (i % 8), 1012, 3, 0);
+        Add(700, 820, 6, 0);
+    }
+    for (i = 0; i < 5; i++) { // real events, 0.5 to 2.5 s
+        Add(40, 900 + Noise(50), 0, 1); // edge of the beam
+        Add(500 + 500L * i, 1020, 8, 1);
+        Add(1500, 820, 6, 0);
+    }
+    Add(3000, 1001, 5, 0); // sitting on the threshold, should not trigger
+    Add(1500, 820, 6, 0);
+    Add(2000, 1018, 14, 1); // noisy event that dips under IR_EXIT now and then
+    Add(1500, 820, 6, 0);
+}
+
+static void Load(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[80];
+    int v, t;
+
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    labelled = 1;
+    while (n < MAX_SAMPLES && fgets(line, sizeof(line), f)) {
+        if (line[0] == '#')
+            continue;
+        t = -1;
+        if (sscanf(line, "%d%*[ ,\t]%d", &v, &t) < 1)
+            continue;
+        if (t < 0)
+            labelled = 0;
+        value[n] = v;
+        truth[n++] = (t > 0);
+    }
+    fclose(f);
+}
+
+// Scores one output sample; start = sample the current truth event began
+static void Score(Result_t *r, long i, char out, char *last, long *start, char *claimed) {
+    if (truth[i] && (i == 0 || !truth[i - 1])) {
+        r->events++;
+        *start = i;
+        *claimed = 0;
+    }
+    if (i > 0 && !truth[i] && truth[i - 1] && !*claimed)
+        r->missed++;
+    if (out && !*last) {
+        if (truth[i] && !*claimed) {
+            double lat = (double) (i - *start) * ADC_SAMPLE_US / 1000.0;
+            r->found++;
+            r->latency += lat;
+            if (lat > r->latencyMax)
+                r->latencyMax = lat;
+            *claimed = 1;
+        } else
+            r->falseTriggers++;
+    }
+    if (!out && *last && *claimed && *start >= 0) {
+        long end = i;
+        while (end > *start && !truth[end - 1])
+            end--;
+        r->release += (double) (i - end) * ADC_SAMPLE_US / 1000.0;
+        r->releases++;
+        *start = -1;
+    }
+    *last = out;
+}
+
+static void Run(Result_t *r, char old) {
+    long i, start = -1, stall = 0;
+    char out = 0, last = 0, claimed = 0;
+    int held = 0;
+
+    IRDetectInit();
+    for (i = 0; i < n; i++) {
+        if (old) {
+            if (stall) {
+                r->frozen++;
+                if (!--stall)
+                    out = (held > 1005);
+            } else if (value[i] > 1000) {
+                held = value[i];
+                stall = 300000L / ADC_SAMPLE_US;
+            }
+        } else
+            out = IRDetectUpdate(ADCScale(value[i]), (unsigned char) i);
+        Score(r, i, out, &last, &start, &claimed);
+    }
+    if (n && truth[n - 1] && !claimed)
+        r->missed++;
+}
+
+static void Print(const Result_t *r) {
+    printf("%-12s", r->name);
+    if (labelled) {
+        printf(" %6ld %6ld %6ld %7ld", r->events, r->found, r->missed, r->falseTriggers);
+        if (r->found)
+            printf(" %9.1f %9.1f", r->latency / r->found, r->latencyMax);
+        else
+            printf(" %9s %9s", "-", "-");
+        if (r->releases)
+            printf(" %9.1f", r->release / r->releases);
+        else
+            printf(" %9s", "-");
+    }
+    printf(" %9.1f\n", r->frozen * ADC_SAMPLE_US / 1000.0);
+}
+
+int main(int argc, char **argv) {
+    static Result_t old, fsm; // every count starts at 0
+
+    old.name = "old loop";
+    fsm.name = "IR Module";
+    if (argc > 1)
+        Load(argv[1]);
+    else
+        BuiltIn();
+
+    printf("%ld samples (%.1f s), enter %d, exit %d, dwell %d ms, release %d ms\n\n",
+            n, n * ADC_SAMPLE_US / 1e6, IR_ENTER, IR_EXIT, IR_DWELL_MS, IR_RELEASE_MS);
+    Run(&old, 1);
+    Run(&fsm, 0);
+    if (labelled)
+        printf("%-12s %6s %6s %6s %7s %9s %9s %9s %9s\n", "", "events", "found", "missed",
+                "false", "lat ms", "max ms", "rel ms", "frozen ms");
+    else
+        printf("%-12s %9s   (no truth column, detection stats skipped)\n", "", "frozen ms");
+    Print(&old);
+    Print(&fsm);
+    printf("\nIR Module dropped %u candidates before the dwell ran out\n", IRDetectRejects);
+    return 0;
+}
@@ -0,0 +1,33 @@
+/*********************************************************************
+ * FileName:        keyhost.h
+ * Processor:       Host (gcc)
+ *
+ * Stand-ins for the PIC18F4520 registers Keycard Module.c touches, so
+ * it can be built with gcc and driven by keyreplay.c.  PORTB is what
+ * the model sets the pins to before it calls KeyISR(), the rest are
+ * only written.
+ ********************************************************************/
+
+#ifndef __KEYHOST_H
+#define __KEYHOST_H
+
+#define rom
+
+typedef struct {
+    unsigned char RBIF : 1, RBIE : 1;
+} HostINTCONbits_t; // INTCONbits, only the change interrupt bits
+
+typedef struct {
+    unsigned char RBPU : 1, RBIP : 1;
+} HostINTCON2bits_t;
+
+typedef struct {
+    unsigned char TRISB4 : 1, TRISB5 : 1;
+} HostTRISBbits_t;
+
+extern volatile unsigned char PORTB;
+extern volatile HostINTCONbits_t INTCONbits;
+extern volatile HostINTCON2bits_t INTCON2bits;
+extern volatile HostTRISBbits_t TRISBbits;
+
+#endif
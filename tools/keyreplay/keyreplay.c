@@ -0,0 +1,231 @@
+/*********************************************************************
+ * FileName:        keyreplay.c
+ * Processor:       Host (gcc)
+ *
+ * Plays clock and data edges through Keycard Module.c at simulated
+ * time, with Timer1 (ClockStamp()) and the scheduler tick running as
+ * on the PIC, and checks what comes out of KeyRead() and KeyErrors:
+ *
+ *   valid swipe     one of keyCombos[], 400 us a bit
+ *   invalid swipe   a code that isn't
+ *   slow swipe      each bit just under KEY_GAP_US after the last
+ *   short gap       a second swipe before the gap is up is the rest of
+ *                   the first, ignored and counted
+ *   long gap        a pause in the middle of a swipe drops both halves
+ *   Timer1 wrap     the next swipe 3 x 65.536 ms + 2 ms after a full one
+ *                   and after half of one, without KeyRead() in between
+ *   65.5 s wait     the same after Timer1 and the ticks have both
+ *                   wrapped, with KeyRead() every 20 ms as taskKeycard
+ *
+ *   gcc -Wall -I tools/keyreplay -I MechatronicsProjectOfDoom.X -o keyreplay \
+ *       tools/keyreplay/keyreplay.c "MechatronicsProjectOfDoom.X/Keycard Module.c" \
+ *       "MechatronicsProjectOfDoom.X/Scheduler Module.c" \
+ *       "MechatronicsProjectOfDoom.X/Event Module.c"
+ *   ./keyreplay [edges]
+ *
+ * An edges file has one change per line, "us clock data" with the pin
+ * levels (0/1) from that time on, the way a logic analyser exports
+ * them; lines starting with # are skipped.  Every swipe it decodes is
+ * printed instead of running the tests.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "keyhost.h"
+#include "Keycard Module.h"
+#include "Scheduler Module.h"
+#include "Event Module.h"
+
+volatile unsigned char PORTB;
+volatile HostINTCONbits_t INTCONbits;
+volatile HostINTCON2bits_t INTCON2bits;
+volatile HostTRISBbits_t TRISBbits;
+
+#define BIT_US          400     // a bit at walking pace
+#define POLL_US         20000L  // taskKeycard
+
+static long long now; // us
+static long long nextTick, nextPoll;
+static char polling;
+static int errors;
+static unsigned char swipes, lastCode;
+static char lastResult;
+
+unsigned int ClockStamp(void) {
+    return (unsigned short) now; // Timer1, 16 bits
+}
+
+static void Poll(void) {
+    unsigned char code;
+    char result = KeyRead(&code);
+
+    if (result == KEY_NONE)
+        return;
+    swipes++;
+    lastCode = code;
+    lastResult = result;
+    while (EventGet() != EV_NONE);
+}
+
+// Moves time on to t, ticking the scheduler and polling on the way
+static void Until(long long t) {
+    while (nextTick <= t || (polling && nextPoll <= t)) {
+        if (nextTick <= t && (!polling || nextTick <= nextPoll)) {
+            now = nextTick;
+            nextTick += SCHED_TICK_US;
+            SchedTick();
+        } else {
+            now = nextPoll;
+            nextPoll += POLL_US;
+            Poll();
+        }
+    }
+    now = t;
+}
+
+// RB4 clock, RB5 data, the change interrupt if either moved
+static void Pins(char clock, char data) {
+    unsigned char pins = 0xFF;
+
+    if (!clock)
+        pins &= ~KEY_CLOCK_MASK;
+    if (!data)
+        pins &= ~KEY_DATA_MASK;
+    if (pins == PORTB)
+        return;
+    PORTB = pins;
+    if (INTCONbits.RBIE) {
+        INTCONbits.RBIF = 1;
+        KeyISR(ClockStamp());
+    }
+}
+
+// bits of code, MSB first, data set up half a bit before the clock falls
+static void Swipe(unsigned char code, int bits, long bitUs) {
+    int i;
+
+    for (i = bits - 1; i >= 0; i--) {
+        Pins(1, (code >> i) & 1);
+        Until(now + bitUs / 2);
+        Pins(0, (code >> i) & 1);
+        Until(now + bitUs - bitUs / 2);
+    }
+    Pins(1, 1);
+}
+
+static void Start(char poll) {
+    now = 0;
+    nextTick = SCHED_TICK_US;
+    nextPoll = POLL_US;
+    polling = poll;
+    PORTB = 0xFF;
+    SchedInit();
+    EventInit();
+    KeyInit();
+    KeyErrors = 0;
+    swipes = 0;
+}
+
+static void Check(const char *name, unsigned char n, unsigned char code, char result,
+        unsigned char keyErrors) {
+    char ok;
+
+    Poll();
+    ok = swipes == n && KeyErrors == keyErrors && (!n || (lastCode == code && lastResult == result));
+    printf("%-16s swipes %u code %02X %-7s errors %u  %s\n", name, swipes, swipes ? lastCode : 0,
+            !swipes ? "-" : lastResult == KEY_VALID ? "valid" : "invalid", KeyErrors, ok ? "ok" : "** wrong");
+    if (!ok) {
+        printf("%16s expected swipes %u code %02X %s errors %u\n", "", n, code,
+                !n ? "-" : result == KEY_VALID ? "valid" : "invalid", keyErrors);
+        errors++;
+    }
+}
+
+static void Replay(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[80];
+    long long t;
+    int clock, data;
+    unsigned char seen = 0;
+
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    Start(1);
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || sscanf(line, "%lld %d %d", &t, &clock, &data) != 3)
+            continue;
+        if (t > now)
+            Until(t);
+        Pins(clock, data);
+        if (swipes != seen) {
+            seen = swipes;
+            printf("%10.3f ms  %02X %s\n", now / 1000.0, lastCode, lastResult == KEY_VALID ? "valid" : "invalid");
+        }
+    }
+    fclose(f);
+    Until(now + KEY_GAP_US + 2 * POLL_US);
+    if (swipes != seen)
+        printf("%10.3f ms  %02X %s\n", now / 1000.0, lastCode, lastResult == KEY_VALID ? "valid" : "invalid");
+    printf("%u edges, %u swipes, %u errors\n", KeyEdges, swipes, KeyErrors);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        Replay(argv[1]);
+        return 0;
+    }
+
+    printf("gap %u us, tick %u us\n\n", KEY_GAP_US, SCHED_TICK_US);
+
+    Start(0);
+    Swipe(0x33, 8, BIT_US);
+    Check("valid swipe", 1, 0x33, KEY_VALID, 0);
+
+    Start(0);
+    Swipe(0x55, 8, BIT_US);
+    Check("invalid swipe", 1, 0x55, KEY_INVALID, 0);
+
+    Start(0);
+    Swipe(0x2A, 8, KEY_GAP_US - 100);
+    Check("slow swipe", 1, 0x2A, KEY_VALID, 0);
+
+    Start(0);
+    Swipe(0x38, 8, BIT_US);
+    Until(now + KEY_GAP_US / 4);
+    Swipe(0x33, 8, BIT_US);
+    Check("short gap", 1, 0x38, KEY_VALID, 1);
+
+    Start(0);
+    Swipe(0x33 >> 4, 4, BIT_US);
+    Until(now + KEY_GAP_US + 5000);
+    Swipe(0x33, 4, BIT_US);
+    Until(now + 100000L);
+    Swipe(0x2A, 8, BIT_US);
+    Check("long gap", 1, 0x2A, KEY_VALID, 2);
+
+    Start(0);
+    Swipe(0x33, 8, BIT_US);
+    Poll(); // straight away, the wait is left to KeyISR()
+    Until(now + 3 * 65536L + 2000 - BIT_US / 2);
+    Swipe(0x38, 8, BIT_US);
+    Check("Timer1 wrap", 2, 0x38, KEY_VALID, 0);
+    Swipe(0x2A >> 4, 4, BIT_US);
+    Until(now + 3 * 65536L + 2000 - BIT_US / 2);
+    Swipe(0x2A, 8, BIT_US);
+    Check("  half a swipe", 3, 0x2A, KEY_VALID, 1);
+
+    Start(1);
+    Swipe(0x33, 8, BIT_US);
+    Until(now + 65536L * SCHED_TICK_US + 2000 - BIT_US / 2);
+    Swipe(0x38, 8, BIT_US);
+    Check("65.5 s wait", 2, 0x38, KEY_VALID, 0);
+    Swipe(0x2A >> 4, 4, BIT_US);
+    Until(now + 65536L * SCHED_TICK_US + 2000 - BIT_US / 2);
+    Swipe(0x2A, 8, BIT_US);
+    Check("  half a swipe", 3, 0x2A, KEY_VALID, 1);
+
+    printf("\n%d errors\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,389 @@
+/*********************************************************************
+ * FileName:        lcdbench.c
+ * Processor:       Host (gcc)
+ *
+ * Instruction cycles the LCD driver spends on each call, measured
+ * against the simulated HD44780 in lcdsim.c.  Build it once per wait
+ * mode:
+ *
+ *   gcc -I tools/lcdsim -I MechatronicsProjectOfDoom.X -o lcdbench \
+ *       tools/lcdsim/lcdsim.c tools/lcdsim/lcdbench.c \
+ *       "MechatronicsProjectOfDoom.X/LCD Module.c" \
+ *       "MechatronicsProjectOfDoom.X/LCD Buffer.c" \
+ *       "MechatronicsProjectOfDoom.X/LCD Glyph.c" \
+ *       "MechatronicsProjectOfDoom.X/LCD Format.c" \
+ *       "MechatronicsProjectOfDoom.X/LCD Screen.c"
+ *   gcc -DXLCD_DELAYMODE ... -o lcdbench-delay (same sources)
+ *   gcc -DXLCD_DELAYMODE -DXLCD_FLATDELAY ... -o lcdbench-2ms (the old
+ *       flat 2 ms a byte, the figures the other two are compared with)
+ *   gcc -DCLOCK_FOSC=32000000UL ... (or 8 or 16 MHz)
+ *   gcc -DXLCD_PORTWRITE ... (the old bit by bit PORTD writes)
+ *
+ * Each figure is the time from the call until it returns, so it
+ * includes waiting for the module to finish whatever came before.
+ * Everything runs blocking except the last table.  The queued figures
+ * only count SFR accesses (the TMR2IE write); the RAM bookkeeping in
+ * XLCDQueueWrite() adds about 20 cycles per byte on C18, which the
+ * simulator cannot see.
+ *
+ * The screen table draws two screens three ways, sprintf() and whole
+ * lines, hand built into the LCD Buffer and from LCD Screen templates,
+ * and puts bus writes next to an estimate of the program memory each
+ * one's drawing code takes on C18 (see ScreenWords()).
+ ********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "LCD Module.h"
+#include "LCD Buffer.h"
+#include "LCD Glyph.h"
+#include "LCD Format.h"
+#include "LCD Screen.h"
+
+extern char _vXLCDnobf;
+
+static char text[] = "0123456789ABCDEF0123456789ABCDEF";
+static unsigned long start;
+
+static void Begin(void) {
+    start = HostCycles;
+}
+
+static unsigned long End(void) {
+    return HostCycles - start;
+}
+
+static double Ms(unsigned long cycles) {
+    return cycles * 4000.0 / HostFoscHz;
+}
+
+static void Report(const char *what, unsigned long cycles, unsigned int per) {
+    printf("%-36s %8lu cycles %8.3f ms", what, cycles, Ms(cycles));
+    if (per > 1)
+        printf("  %6lu /char", cycles / per);
+    printf("\n");
+}
+
+// Cycles XLCDPutRamString() holds up the caller for an n character string
+static unsigned long StringCall(int n) {
+    unsigned long isr = HostIsrCycles;
+    char save = text[n];
+
+    text[n] = 0;
+    Begin();
+    XLCDL1home();
+    XLCDPutRamString(text);
+    text[n] = save;
+    return End() - (HostIsrCycles - isr);
+}
+
+// IR readings as they come in from the sensor, one status screen each
+static const int readings[] = {
+    812, 815, 815, 820, 870, 944, 998, 1003, 1004, 1006,
+    1006, 1005, 1007, 1004, 999, 990, 940, 880, 850, 851
+};
+
+static void StatusScreen(char *line, int ir) {
+    sprintf(line, "IR %4d  %s", ir, ir > 1005 ? "LOCKED" : "  OPEN");
+}
+
+// Status screen redrawn in full each frame vs. through the frame buffer
+static void FrameBuffer(void) {
+    char line[17];
+    unsigned long full, diffed;
+    unsigned int i, n = sizeof(readings) / sizeof(readings[0]);
+
+    Begin();
+    for (i = 0; i < n; i++) {
+        StatusScreen(line, readings[i]);
+        XLCDL1home();
+        XLCDPutRamString(line);
+        XLCDL2home();
+        XLCDPutRomString("Door    CLOSED  ");
+    }
+    full = End();
+
+    XLCDClear();
+    XLCDBufInit();
+    Begin();
+    for (i = 0; i < n; i++) {
+        StatusScreen(line, readings[i]);
+        XLCDBufPutRamString(0, 0, line);
+        XLCDBufPutRomString(1, 0, "Door    CLOSED  ");
+        XLCDBufCommit();
+    }
+    diffed = End();
+
+    printf("\n%u status screens, full redraw: %u writes, %lu cycles\n", n,
+            n * XLCD_ROWS * (XLCD_COLS + 1), full);
+    printf("frame buffer: %lu chars + %lu set address = %lu writes, %lu saved, %lu cycles\n",
+            XLCDBufBytesSent, XLCDBufCmdsSent, XLCDBufBytesSent + XLCDBufCmdsSent,
+            XLCDBufSaved, diffed);
+}
+
+// Two screens, a status screen with a reading and a door state, and a
+// settings screen, drawn for 20 readings, 10 of the other and 10 more
+// of the first, every way the firmware has had of drawing them
+#define STATUS_IR       0
+#define STATUS_LOCK     1
+#define STATUS_DOOR     2
+#define SET_ENTER       0
+#define SET_DWELL       1
+static XLCDField statusFields[] = {{0, 3, 4}, {0, 9, 6}, {1, 8, 6}};
+static XLCDScreen status = {"IR              " "Door            ", statusFields, 3};
+static XLCDField setFields[] = {{0, 6, 4}, {1, 6, 4}};
+static XLCDScreen settings = {"Enter         on" "Dwell         ms", setFields, 2};
+
+#define SCREEN_SWITCH1  20      // frame the settings screen comes up
+#define SCREEN_SWITCH2  30      // and goes again
+#define SCREEN_FRAMES   40
+
+static int ScreenReading(unsigned int frame) {
+    return readings[frame % (sizeof(readings) / sizeof(readings[0]))];
+}
+
+static int OnSettings(unsigned int frame) {
+    return frame >= SCREEN_SWITCH1 && frame < SCREEN_SWITCH2;
+}
+
+// Estimated C18 program words for a call: CALL, a MOVLW/MOVWF pair per
+// argument byte pushed and, with arguments, two to pop them; a ROM
+// string is half a word a character
+static unsigned int Call(unsigned int argBytes) {
+    return 2 + 2 * argBytes + (argBytes ? 2 : 0);
+}
+
+// Estimated program words for each way's drawing code, both screens,
+// not counting the library it calls (sprintf() is about 2k words on
+// C18, LCD Format and LCD Buffer are linked in for the rest anyway)
+static void ScreenWords(unsigned int *words) {
+    // sprintf(line, "IR %4d  %s", ...), 2 x home + XLCDPutRamString(line), for each screen
+    words[0] = Call(8) + (sizeof "IR %4d  %s" + sizeof "LOCKED" + sizeof "  OPEN") / 2
+            + 2 * (2 * Call(0) + 2 * Call(2)) + sizeof "Door    CLOSED  " / 2
+            + Call(6) + (sizeof "Enter %4d on" + sizeof "Dwell %4d ms") / 2 + Call(6);
+    // XLCDFmtToFrame() + XLCDFmtRom()/UDec() for every piece of text and every field
+    words[1] = 3 * Call(2) + 2 * Call(2) + Call(4) + 2 * Call(2)
+            + (sizeof "IR " + sizeof "LOCKED" + sizeof "  OPEN" + sizeof "Door    " + sizeof "CLOSED") / 2
+            + 2 * Call(2) + 2 * Call(2) + 2 * Call(4) + (sizeof "Enter " + sizeof " on"
+            + sizeof "Dwell " + sizeof " ms") / 2 + Call(0);
+    // XLCDScreenShow() + one helper per field, the templates and field tables
+    words[2] = 2 * Call(2) + Call(5) + 2 * Call(5) + 2 * Call(5)
+            + (2 * XLCD_ROWS * XLCD_COLS + 3 * 5 + 2 * 5) / 2
+            + (sizeof "LOCKED" + sizeof "  OPEN" + sizeof "CLOSED") / 2;
+}
+
+static void Screens(void) {
+    static const char *how[3] = {"sprintf + home + whole lines", "hand built, LCD Buffer",
+        "LCD Screen templates"};
+    unsigned long cycles, writes, instructions, characters;
+    unsigned int frame, words[3];
+    char line[20];
+    int way, ir, wasSettings;
+
+    ScreenWords(words);
+    printf("\n%d frames, two screens, %d switches\n", SCREEN_FRAMES, 2);
+    printf("%-30s %7s %10s %11s\n", "", "writes", "cycles", "est. words");
+    for (way = 0; way < 3; way++) {
+        XLCDClear();
+        XLCDBufInit();
+        XLCDScreenShow(0);
+        instructions = HostLcd.instructions;
+        characters = HostLcd.characters;
+        wasSettings = 0;
+        Begin();
+        for (frame = 0; frame < SCREEN_FRAMES; frame++) {
+            ir = ScreenReading(frame);
+            if (way == 0) {
+                if (OnSettings(frame)) {
+                    sprintf(line, "Enter %4d    on", 1005);
+                    XLCDL1home();
+                    XLCDPutRamString(line);
+                    sprintf(line, "Dwell %4d    ms", 40);
+                    XLCDL2home();
+                    XLCDPutRamString(line);
+                } else {
+                    StatusScreen(line, ir);
+                    XLCDL1home();
+                    XLCDPutRamString(line);
+                    XLCDL2home();
+                    XLCDPutRomString("Door    CLOSED  ");
+                }
+                continue;
+            }
+            if (way == 1) {
+                if (OnSettings(frame) != wasSettings)
+                    XLCDBufClear();
+                if (OnSettings(frame)) {
+                    XLCDFmtToFrame(0, 0);
+                    XLCDFmtRom("Enter ");
+                    XLCDFmtUDec(1005, 4, ' ');
+                    XLCDFmtRom("    on");
+                    XLCDFmtToFrame(1, 0);
+                    XLCDFmtRom("Dwell ");
+                    XLCDFmtUDec(40, 4, ' ');
+                    XLCDFmtRom("    ms");
+                } else {
+                    XLCDFmtToFrame(0, 0);
+                    XLCDFmtRom("IR ");
+                    XLCDFmtUDec(ir, 4, ' ');
+                    XLCDFmtRom(ir > 1005 ? "  LOCKED" : "    OPEN");
+                    XLCDFmtToFrame(1, 0);
+                    XLCDFmtRom("Door    CLOSED  ");
+                }
+            } else if (OnSettings(frame)) {
+                XLCDScreenShow(&settings);
+                XLCDScreenUDec(&settings, SET_ENTER, 1005);
+                XLCDScreenUDec(&settings, SET_DWELL, 40);
+            } else {
+                XLCDScreenShow(&status);
+                XLCDScreenUDec(&status, STATUS_IR, ir);
+                XLCDScreenRom(&status, STATUS_LOCK, ir > 1005 ? "LOCKED" : "  OPEN");
+                XLCDScreenRom(&status, STATUS_DOOR, "CLOSED");
+            }
+            wasSettings = OnSettings(frame);
+            XLCDBufCommit();
+        }
+        cycles = End();
+        writes = HostLcd.instructions - instructions + HostLcd.characters - characters;
+        HostLcdLine(0, line, 16);
+        printf("%-30s %7lu %10lu %11u   [%s]\n", how[way], writes, cycles, words[way], line);
+    }
+    printf("(est. words leave out the library code, sprintf() alone is several thousand)\n");
+
+    // A reading too wide for its 4 cells fills them with #, the top
+    // digits aren't shown without the bottom ones
+    XLCDScreenShow(&status);
+    XLCDScreenUDec(&status, STATUS_IR, 9999);
+    XLCDBufCommit();
+    HostLcdLine(0, line, 16);
+    if (strncmp(line + 3, "9999", 4))
+        printf("  ** 9999 in 4 cells [%s], expected [IR 9999]\n", line);
+    XLCDScreenUDec(&status, STATUS_IR, 12345);
+    XLCDBufCommit();
+    HostLcdLine(0, line, 16);
+    if (strncmp(line + 3, "####", 4))
+        printf("  ** 12345 in 4 cells [%s], expected [IR ####]\n", line);
+    XLCDScreenShow(0);
+    XLCDBufCommit();
+}
+
+// IR readings drawn as a bar graph, first sweep loads the glyphs, the second should not
+static void BarGraph(void) {
+    unsigned long uploads, hits, instructions;
+    int pass, i;
+
+    XLCDGlyphInit();
+    for (pass = 0; pass < 2; pass++) {
+        uploads = XLCDGlyphUploads;
+        hits = XLCDGlyphHits;
+        instructions = HostLcd.instructions;
+        Begin();
+        for (i = 0; i <= 1023; i += 7) {
+            XLCDBarGraph(1, 0, 16, i, 1023);
+            XLCDBufCommit();
+        }
+        printf("bar graph sweep %d: %lu glyph uploads, %lu hits, %lu instructions, %lu cycles\n",
+                pass + 1, XLCDGlyphUploads - uploads, XLCDGlyphHits - hits,
+                HostLcd.instructions - instructions, End());
+    }
+}
+
+static void Queue(void) {
+    static const int lengths[] = {4, 8, 16, 32};
+    unsigned long blocking[4];
+    unsigned long isr, call;
+    int i;
+
+    for (i = 0; i < 4; i++)
+        blocking[i] = StringCall(lengths[i]);
+
+    XLCDQueueInit();
+    HostTimer2Isr = XLCDQueueISR;
+    printf("\nchars  blocking call  queued call  drain time  isr cycles\n");
+    for (i = 0; i < 4; i++) {
+        isr = HostIsrCycles;
+        call = StringCall(lengths[i]);
+        XLCDFlush();
+        printf("%5d  %13lu  %11lu  %10lu  %10lu\n", lengths[i], blocking[i], call,
+                End(), HostIsrCycles - isr);
+    }
+}
+
+int main(void) {
+    char line[17];
+    int i;
+
+    HostReset();
+#if defined(XLCD_READBFMODE)
+    printf("wait mode: busy flag (XLCD_READBFMODE), %lu MHz\n\n", HostFoscHz / 1000000);
+#elif defined(XLCD_FLATDELAY)
+    printf("wait mode: flat 2 ms a byte (XLCD_DELAYMODE, XLCD_FLATDELAY), %lu MHz\n\n", HostFoscHz / 1000000);
+#else
+    printf("wait mode: fixed delay (XLCD_DELAYMODE), %lu MHz\n\n", HostFoscHz / 1000000);
+#endif
+
+    Begin();
+    XLCDInit();
+    Report("XLCDInit()", End(), 1);
+
+    Begin();
+    XLCDClear();
+    XLCDCommand(0x80);
+    Report("XLCDClear() + XLCDCommand(0x80)", End(), 1);
+
+    Begin();
+    for (i = 0; i < 16; i++)
+        XLCDCommand(0x80 | i);
+    Report("XLCDCommand(0x80|addr) x16", End(), 16);
+
+    Begin();
+    XLCDL1home();
+    for (i = 0; i < 16; i++)
+        XLCDPut(text[i]);
+    Report("XLCDPut() x16", End(), 16);
+
+    text[16] = 0;
+    Begin();
+    XLCDL1home();
+    XLCDPutRamString(text);
+    Report("XLCDPutRamString() 16 chars", End(), 16);
+    text[16] = '0';
+
+    Begin();
+    XLCDL2home();
+    XLCDPutRomString("Newhaven 2x16 OK");
+    Report("XLCDPutRomString() 16 chars", End(), 16);
+
+    Begin();
+    XLCDL1home();
+    XLCDPutRomString("0123456789ABCDEF");
+    XLCDL2home();
+    XLCDPutRomString("fedcba9876543210");
+    Report("full screen (2 x home + 32 chars)", End(), 32);
+
+    HostLcdLine(0, line, 16);
+    printf("\nline 1 [%s]\n", line);
+    if (strcmp(line, "0123456789ABCDEF"))
+        printf("  ** expected [0123456789ABCDEF]\n");
+    HostLcdLine(1, line, 16);
+    printf("line 2 [%s]\n", line);
+    if (strcmp(line, "fedcba9876543210"))
+        printf("  ** expected [fedcba9876543210]\n");
+
+    FrameBuffer();
+    Screens();
+    printf("\n");
+    BarGraph();
+    Queue();
+
+    printf("\n%lu instructions, %lu characters, %lu status reads found it busy\n",
+            HostLcd.instructions, HostLcd.characters, HostLcd.busyReads);
+    if (_vXLCDnobf)
+        printf("busy flag timed out, fell back to XLCDDelay()\n");
+    printf("violations: write while busy %lu, EN width %lu, EN cycle %lu, "
+            "data moved under EN %lu, bus contention %lu, too soon after power up %lu\n",
+            HostLcd.violations.writeBusy, HostLcd.violations.enWidth, HostLcd.violations.enCycle,
+            HostLcd.violations.dataChanged, HostLcd.violations.contention,
+            HostLcd.violations.earlyInit);
+    return 0;
+}
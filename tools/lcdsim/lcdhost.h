@@ -0,0 +1,128 @@
+/*********************************************************************
+ * FileName:        lcdhost.h
+ * Processor:       Host (gcc)
+ *
+ * Stand-ins for the PIC18F4520 bits of the C18 environment that
+ * LCD Module.c touches, so the driver can be built with gcc and run
+ * against the simulated HD44780 in lcdsim.c.
+ *
+ * Every PORTD/LATD/TRISD access goes through a function so the simulator
+ * sees the pins change and can charge instruction cycles for it.
+ ********************************************************************/
+
+#ifndef __LCDHOST_H
+#define __LCDHOST_H
+
+#define rom
+
+typedef struct {
+    unsigned char RD0 : 1;
+    unsigned char RD1 : 1;
+    unsigned char RD2 : 1;
+    unsigned char RD3 : 1;
+    unsigned char RD4 : 1;
+    unsigned char RD5 : 1;
+    unsigned char RD6 : 1;
+    unsigned char RD7 : 1;
+} HostPORTDbits_t;
+
+typedef struct {
+    unsigned char TRISD0 : 1;
+    unsigned char TRISD1 : 1;
+    unsigned char TRISD2 : 1;
+    unsigned char TRISD3 : 1;
+    unsigned char TRISD4 : 1;
+    unsigned char TRISD5 : 1;
+    unsigned char TRISD6 : 1;
+    unsigned char TRISD7 : 1;
+} HostTRISDbits_t;
+
+typedef struct {
+    unsigned char TMR1IF : 1;
+    unsigned char TMR2IF : 1;
+    unsigned char CCP1IF : 1;
+    unsigned char SSPIF : 1;
+    unsigned char TXIF : 1;
+    unsigned char RCIF : 1;
+    unsigned char ADIF : 1;
+    unsigned char PSPIF : 1;
+} HostPIR1bits_t;
+
+typedef struct {
+    unsigned char TMR1IE : 1;
+    unsigned char TMR2IE : 1;
+    unsigned char CCP1IE : 1;
+    unsigned char SSPIE : 1;
+    unsigned char TXIE : 1;
+    unsigned char RCIE : 1;
+    unsigned char ADIE : 1;
+    unsigned char PSPIE : 1;
+} HostPIE1bits_t;
+
+typedef struct {
+    unsigned char TMR1IP : 1;
+    unsigned char TMR2IP : 1;
+    unsigned char CCP1IP : 1;
+    unsigned char SSPIP : 1;
+    unsigned char TXIP : 1;
+    unsigned char RCIP : 1;
+    unsigned char ADIP : 1;
+    unsigned char PSPIP : 1;
+} HostIPR1bits_t;
+
+volatile unsigned char *HostPortD(void);
+volatile unsigned char *HostTrisD(void);
+volatile unsigned char *HostLatD(void);
+
+#define PORTD       (*HostPortD())
+#define PORTDbits   (*(volatile HostPORTDbits_t *)HostPortD())
+#define TRISD       (*HostTrisD())
+#define TRISDbits   (*(volatile HostTRISDbits_t *)HostTrisD())
+#define LATD        (*HostLatD())
+
+// Timer2 and its interrupt, used by the LCD transmit queue
+extern volatile unsigned char PR2;
+extern volatile unsigned char T2CON;
+extern volatile HostPIR1bits_t PIR1bits;
+extern volatile HostIPR1bits_t IPR1bits;
+volatile unsigned char *HostPie1(void);
+#define PIE1bits    (*(volatile HostPIE1bits_t *)HostPie1())
+
+void Nop(void);
+void Delay10TCYx(unsigned char unit);
+void Delay100TCYx(unsigned char unit);
+void Delay1KTCYx(unsigned char unit);
+void Delay10KTCYx(unsigned char unit);
+
+// Simulator side
+typedef struct {
+    unsigned long writeBusy;        // instruction or data written while the module was busy
+    unsigned long enWidth;          // EN high for less than 450 ns
+    unsigned long enCycle;          // EN rising edges less than 1000 ns apart
+    unsigned long dataChanged;      // DB7:DB4 or RS moved while EN was high on a write
+    unsigned long contention;       // module driving DB7:DB4 while the PIC drives them too
+    unsigned long earlyInit;        // strobed within 15 ms of the module being powered
+} HostLcdViolations_t;
+
+typedef struct {
+    unsigned char ddram[128];
+    unsigned char cgram[64];
+    unsigned char ac;               // address counter
+    signed char shift;              // display shift
+    char twoLine, display, cursor, blink, increment, entryShift;
+    unsigned long instructions;
+    unsigned long characters;       // data writes
+    unsigned long busyReads;        // status reads that found the module busy
+    HostLcdViolations_t violations;
+} HostLcd_t;
+
+extern unsigned long HostFoscHz;    // PIC oscillator, 4 MHz unless changed before HostReset()
+extern unsigned long HostCycles;    // instruction cycles spent so far (Fosc/4)
+extern unsigned long HostIsrCycles; // ... of which inside the Timer2 interrupt
+extern void (*HostTimer2Isr)(void); // called on every enabled Timer2 tick
+extern HostLcd_t HostLcd;
+
+void HostReset(void);
+void HostLcdLine(unsigned char row, char *text, unsigned char cols); // visible text of a row
+
+#endif
@@ -0,0 +1,365 @@
+/*********************************************************************
+ * FileName:        lcdsim.c
+ * Processor:       Host (gcc)
+ *
+ * Simulated PORTD with an HD44780 hanging off it, wired the way the
+ * PICDEM 2 board does it (see LCD Module.h):
+ *   RD3:RD0 = DB7:DB4, RD4 = RS, RD5 = RW, RD6 = EN, RD7 = LCD power
+ *
+ * Time is counted in PIC instruction cycles (Fosc/4).  Port accesses
+ * are charged 2 cycles (the bit op plus the W shuffling around it),
+ * Nop() 1 cycle and the Delay functions what they ask for, which lands
+ * within a few percent of what C18 generates for the driver.
+ *
+ * The module decodes EN strobes in 4 bit mode on the lower nibble
+ * (after the 8 bit function sets of the init sequence), keeps DDRAM,
+ * CGRAM, the address counter and the display/entry mode settings, and
+ * goes busy for the datasheet execution time of each instruction.
+ * Anything the driver does that the datasheet doesn't allow is counted
+ * in HostLcd.violations rather than stopping the run.
+ *
+ * Timer2 runs off the same cycle count.  When its interrupt is enabled
+ * HostTimer2Isr is called on each postscaled period, charged
+ * ISR_OVERHEAD cycles for the interruptlow context save/restore.
+ ********************************************************************/
+
+#include <string.h>
+#include "lcdhost.h"
+#include "Clock Module.h"
+
+#define EN_BIT      0x40
+#define RW_BIT      0x20
+#define RS_BIT      0x10
+#define PWR_BIT     0x80
+#define DB_BITS     0x0F
+
+#define ISR_OVERHEAD 60
+
+unsigned long HostFoscHz = CLOCK_FOSC;
+unsigned long HostCycles;
+unsigned long HostIsrCycles;
+void (*HostTimer2Isr)(void);
+HostLcd_t HostLcd;
+
+volatile unsigned char PR2;
+volatile unsigned char T2CON;
+volatile HostPIR1bits_t PIR1bits;
+volatile HostIPR1bits_t IPR1bits;
+static volatile unsigned char pie1;
+static unsigned long t2Next;
+static char inIsr;
+
+static volatile unsigned char portd;    // what the driver sees
+static volatile unsigned char latd;     // LATD, reads back the latch
+static char latLast;                    // last access was LATD rather than PORTD
+static volatile unsigned char trisd;
+static unsigned char lat;               // pins as last written
+static unsigned char pins;              // what actually reaches the module
+static unsigned long lastWrite;         // cycle count the last access happened at
+
+static unsigned long busyUntil;
+static unsigned long powerOn;
+static char powered;
+static char fourBit;                    // interface switched to 4 bit yet
+static char resets;                     // 8 bit function sets seen (init by instruction)
+static char nibblePhase;                // 0 = waiting for high nibble
+static unsigned char nibbleHigh;
+static char readPhase;
+static unsigned char readByte;
+static unsigned long enRise;
+static unsigned char enRisePins;
+static char enContention;
+static char cgram;                      // address counter points into CGRAM
+
+// Nanoseconds to instruction cycles, rounded up
+static unsigned long Cycles(unsigned long ns) {
+    unsigned long tcy = 4000000000UL / HostFoscHz;
+
+    return (ns + tcy - 1) / tcy;
+}
+
+static unsigned long Ns(unsigned long cycles) {
+    return cycles * (4000000000UL / HostFoscHz);
+}
+
+static void Busy(unsigned long ns) {
+    busyUntil = lastWrite + Cycles(ns);
+}
+
+// Next DDRAM address, 2 line mode skips from the end of line 1 to line 2
+static unsigned char Step(unsigned char addr, char up) {
+    if (cgram)
+        return (addr + (up ? 1 : -1)) & 0x3F;
+    if (!HostLcd.twoLine)
+        return up ? (addr >= 0x4F ? 0x00 : addr + 1) : (addr == 0x00 ? 0x4F : addr - 1);
+    if (up)
+        return addr == 0x27 ? 0x40 : addr == 0x67 ? 0x00 : addr + 1;
+    return addr == 0x40 ? 0x27 : addr == 0x00 ? 0x67 : addr - 1;
+}
+
+static void Instruction(unsigned char cmd) {
+    if (cmd == 0x01) {                  // clear display
+        memset(HostLcd.ddram, ' ', sizeof(HostLcd.ddram));
+        HostLcd.ac = 0;
+        HostLcd.increment = 1;
+        HostLcd.shift = 0;
+        cgram = 0;
+        Busy(1520000UL);
+    } else if (cmd < 0x04) {            // return home
+        HostLcd.ac = 0;
+        HostLcd.shift = 0;
+        cgram = 0;
+        Busy(1520000UL);
+    } else {
+        if (cmd & 0x80) {               // set DDRAM address
+            HostLcd.ac = cmd & 0x7F;
+            cgram = 0;
+        } else if (cmd & 0x40) {        // set CGRAM address
+            HostLcd.ac = cmd & 0x3F;
+            cgram = 1;
+        } else if (cmd & 0x20) {        // function set
+            HostLcd.twoLine = (cmd >> 3) & 1;
+            if (cmd & 0x10)
+                fourBit = 0;
+        } else if (cmd & 0x10) {        // cursor / display shift
+            if (cmd & 0x08)
+                HostLcd.shift += (cmd & 0x04) ? 1 : -1;
+            else
+                HostLcd.ac = Step(HostLcd.ac, cmd & 0x04);
+        } else if (cmd & 0x08) {        // display on/off control
+            HostLcd.display = (cmd >> 2) & 1;
+            HostLcd.cursor = (cmd >> 1) & 1;
+            HostLcd.blink = cmd & 1;
+        } else if (cmd & 0x04) {        // entry mode set
+            HostLcd.increment = (cmd >> 1) & 1;
+            HostLcd.entryShift = cmd & 1;
+        }
+        Busy(37000UL);
+    }
+    HostLcd.instructions++;
+}
+
+static void Data(unsigned char value) {
+    if (cgram)
+        HostLcd.cgram[HostLcd.ac & 0x3F] = value;
+    else
+        HostLcd.ddram[HostLcd.ac & 0x7F] = value;
+    HostLcd.ac = Step(HostLcd.ac, HostLcd.increment);
+    if (HostLcd.entryShift && !cgram)
+        HostLcd.shift += HostLcd.increment ? -1 : 1;
+    HostLcd.characters++;
+    Busy(41000UL);                      // 37 us plus the 4 us address update
+}
+
+static void Write(unsigned char rs, unsigned char value) {
+    if (lastWrite < busyUntil)
+        HostLcd.violations.writeBusy++;
+    if (rs)
+        Data(value);
+    else
+        Instruction(value);
+}
+
+static unsigned char ReadValue(unsigned char rs) {
+    unsigned char value;
+
+    if (!rs)
+        return (lastWrite < busyUntil ? 0x80 : 0x00) | HostLcd.ac;
+    value = cgram ? HostLcd.cgram[HostLcd.ac & 0x3F] : HostLcd.ddram[HostLcd.ac & 0x7F];
+    return value;
+}
+
+static void Rise(void) {
+    if (enRise && Ns(lastWrite - enRise) < 1000)
+        HostLcd.violations.enCycle++;
+    if (!powered || lastWrite - powerOn < Cycles(15000000UL))
+        HostLcd.violations.earlyInit++;
+    enRise = lastWrite;
+    enRisePins = pins;
+    enContention = 0;
+    if (pins & RW_BIT) {
+        if (readPhase == 0)
+            readByte = ReadValue(pins & RS_BIT);
+        if ((pins & RS_BIT) == 0 && lastWrite < busyUntil)
+            HostLcd.busyReads++;
+    }
+}
+
+static void Fall(void) {
+    unsigned char nibble = enRisePins & DB_BITS;
+
+    if (Ns(lastWrite - enRise) < 450)
+        HostLcd.violations.enWidth++;
+    if (enContention)
+        HostLcd.violations.contention++;
+
+    if (enRisePins & RW_BIT) {          // read cycle, the module drove the pins
+        readPhase ^= 1;
+        if (readPhase == 0 && (enRisePins & RS_BIT))
+            HostLcd.ac = Step(HostLcd.ac, HostLcd.increment);
+        return;
+    }
+    if ((pins ^ enRisePins) & (DB_BITS | RS_BIT))
+        HostLcd.violations.dataChanged++;
+
+    if (!fourBit) {                     // 8 bit mode, DB3:DB0 of the module aren't wired
+        if (lastWrite < busyUntil)
+            HostLcd.violations.writeBusy++;
+        if (nibble == 0x02)             // function set with DL = 0
+            fourBit = 1;
+        HostLcd.instructions++;
+        // init by instruction: >4.1 ms after the first 0x3, >100 us after the second
+        Busy(resets == 0 ? 4100000UL : resets == 1 ? 100000UL : 37000UL);
+        resets++;
+        return;
+    }
+    if (nibblePhase == 0) {
+        nibbleHigh = nibble;
+        nibblePhase = 1;
+        return;
+    }
+    nibblePhase = 0;
+    Write(enRisePins & RS_BIT, (nibbleHigh << 4) | nibble);
+}
+
+static unsigned long Timer2Period(void) {
+    static const unsigned char prescale[4] = {1, 4, 16, 16};
+
+    return (PR2 + 1UL) * prescale[T2CON & 0x03] * (((T2CON >> 3) & 0x0F) + 1);
+}
+
+static void Timer2(void) {
+    unsigned long start;
+
+    if (!(T2CON & 0x04)) {
+        t2Next = HostCycles + Timer2Period();
+        return;
+    }
+    while (HostCycles >= t2Next) {
+        t2Next += Timer2Period();
+        if (!(pie1 & 0x02) || !HostTimer2Isr || inIsr)
+            continue;
+        inIsr = 1;
+        start = HostCycles;
+        HostCycles += ISR_OVERHEAD;
+        PIR1bits.TMR2IF = 1;
+        HostTimer2Isr();
+        HostIsrCycles += HostCycles - start;
+        inIsr = 0;
+    }
+}
+
+// Catch up with whatever the driver wrote since the last access
+static void Sync(void) {
+    unsigned char old = pins;
+    unsigned char drive;
+
+    lat = latLast ? latd : portd;       // a PORTD write lands in the latch too
+    latd = portd = lat;
+    pins = lat & ~trisd;                // inputs float low as far as the module cares
+
+    if (!(old & PWR_BIT) && (pins & PWR_BIT)) {
+        powered = 1;
+        powerOn = lastWrite;
+    }
+    if (!(old & EN_BIT) && (pins & EN_BIT))
+        Rise();
+    else if ((old & EN_BIT) && !(pins & EN_BIT))
+        Fall();
+
+    if ((pins & (EN_BIT | RW_BIT)) == (EN_BIT | RW_BIT)) {
+        if ((~trisd) & DB_BITS)
+            enContention = 1;
+        if ((pins & RS_BIT) == 0)       // status reads follow the busy flag while EN is high
+            readByte = ReadValue(0);
+        drive = readPhase ? (readByte & 0x0F) : (readByte >> 4);
+        portd = (lat & ~(trisd & DB_BITS)) | (drive & trisd & DB_BITS);
+    }
+    Timer2();
+}
+
+volatile unsigned char *HostPortD(void) {
+    Sync();
+    HostCycles += 2;
+    lastWrite = HostCycles;
+    latLast = 0;
+    return &portd;
+}
+
+volatile unsigned char *HostLatD(void) {
+    Sync();
+    HostCycles += 2;
+    lastWrite = HostCycles;
+    latLast = 1;
+    return &latd;
+}
+
+volatile unsigned char *HostTrisD(void) {
+    Sync();
+    HostCycles += 2;
+    lastWrite = HostCycles;
+    return &trisd;
+}
+
+volatile unsigned char *HostPie1(void) {
+    Sync();
+    HostCycles += 2;
+    lastWrite = HostCycles;
+    return &pie1;
+}
+
+void Nop(void) {
+    Sync();
+    HostCycles += 1;
+    lastWrite = HostCycles;
+}
+
+static void Delay(unsigned long cycles) {
+    Sync();
+    HostCycles += cycles;
+    lastWrite = HostCycles;
+}
+
+void Delay10TCYx(unsigned char unit) {
+    Delay(10UL * (unit ? unit : 256));
+}
+
+void Delay100TCYx(unsigned char unit) {
+    Delay(100UL * (unit ? unit : 256));
+}
+
+void Delay1KTCYx(unsigned char unit) {
+    Delay(1000UL * (unit ? unit : 256));
+}
+
+void Delay10KTCYx(unsigned char unit) {
+    Delay(10000UL * (unit ? unit : 256));
+}
+
+void HostReset(void) {
+    HostCycles = HostIsrCycles = 0;
+    lastWrite = 0;
+    pie1 = T2CON = PR2 = 0;
+    t2Next = 0;
+    portd = latd = lat = pins = 0;
+    latLast = 0;
+    trisd = 0xFF;
+    busyUntil = powerOn = 0;
+    powered = fourBit = resets = 0;
+    nibblePhase = readPhase = 0;
+    enRise = 0;
+    cgram = 0;
+    memset(&HostLcd, 0, sizeof(HostLcd));
+    memset(HostLcd.ddram, ' ', sizeof(HostLcd.ddram));
+    HostLcd.increment = 1;
+}
+
+void HostLcdLine(unsigned char row, char *text, unsigned char cols) {
+    unsigned char addr = (row & 1 ? 0x40 : 0x00) + (row & 2 ? cols : 0);
+    unsigned char i;
+
+    Sync();                             // the last EN fall may not have been seen yet
+    for (i = 0; i < cols; i++)
+        text[i] = HostLcd.ddram[(addr + i) & 0x7F];
+    text[cols] = 0;
+}
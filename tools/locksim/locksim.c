@@ -0,0 +1,247 @@
+/*********************************************************************
+ * FileName:        locksim.c
+ * Processor:       Host (gcc)
+ *
+ * Runs Lock Module.c and Event Module.c against a script of events
+ * and checks where the lock ends up.
+ *
+ *   gcc -Wall -I MechatronicsProjectOfDoom.X -o locksim tools/locksim/locksim.c \
+ *       "MechatronicsProjectOfDoom.X/Lock Module.c" \
+ *       "MechatronicsProjectOfDoom.X/Event Module.c"
+ *   ./locksim [script]
+ *
+ * Time moves on 1 ms at a time, as on the PIC: the events due at that
+ * millisecond are posted (card swipes to EVQ_HIGH like KeyISR(), the
+ * rest to EVQ_MAIN like the tasks), LockTick() runs every LOCK_TICK_MS,
+ * then the queues are emptied through LockDispatch() like DoorRun().
+ *
+ * A script line is a time in ms followed by any of
+ *   card badcard code beam clear    post that event
+ *   xN                              ... N times in a row (queue overflow)
+ *   state=NAME                      check the state after this ms:
+ *                                   locked unlocking unlocked open locking
+ *   bolt=stop|open|close            check the last LockBolt() move
+ *   ignored=N  overflows=N          check LockIgnored, the EventOverflows total
+ * Lines starting with # are skipped.  Without a file the built in
+ * script is used.  After the script, 256 bad swipes a ms apart, enough
+ * to wrap an unsigned char LockFails to 0, have to leave cards locked
+ * out.  Exits 1 if any check fails.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Lock Module.h"
+
+static const char *states[LOCK_STATES] = {"locked", "unlocking", "unlocked", "open", "locking"};
+static const char *moves[] = {"stop", "open", "close"};
+static const char *events[EV_COUNT] = {"none", "card", "badcard", "code", "beam", "clear", "timeout"};
+
+static const char *builtIn[] = {
+    "# card opens it, walk through, relocks behind",
+    "0     state=locked bolt=stop",
+    "1000  card state=unlocking bolt=open",
+    "1850  state=unlocked bolt=stop",
+    "2500  beam state=open",
+    "3500  clear state=unlocked",
+    "4550  state=locking bolt=close",
+    "5350  state=locked bolt=stop",
+    "# nobody comes through, relocks after LOCK_WAIT_MS",
+    "6000  code state=unlocking",
+    "6850  state=unlocked",
+    "11850 state=locking",
+    "# three bad swipes lock cards and codes out",
+    "13000 badcard",
+    "13100 badcard",
+    "13200 badcard state=locked",
+    "13300 card code state=locked ignored=2",
+    "43300 card state=unlocking",
+    "# someone walks in while it is closing",
+    "44150 state=unlocked",
+    "49150 state=locking",
+    "49300 beam state=unlocking bolt=open",
+    "# ... and stays in the beam past the wait",
+    "55150 state=unlocked ignored=3",
+    "56000 clear",
+    "57050 state=locking",
+    "# a swipe in the same ms the closing timer runs out: the swipe",
+    "# is handled first and the queued timeout is stale",
+    "57800 card state=unlocking ignored=4",
+    "58650 state=unlocked",
+    "# a burst of events overflows EVQ_MAIN",
+    "59000 beam x12 state=open overflows=4",
+    "59500 clear state=unlocked",
+    "61500 state=locked bolt=stop",
+    NULL
+};
+
+static int errors;
+static long now;
+static unsigned char lastMove = LOCK_BOLT_STOP;
+
+void LockBolt(unsigned char move) {
+    printf("%7ld ms    bolt %s\n", now, moves[move]);
+    lastMove = move;
+}
+
+static void Fail(const char *line, const char *what, const char *got) {
+    errors++;
+    printf("  ** %ld ms: %s, got %s  [%s]\n", now, what, got, line);
+}
+
+static int Lookup(const char **names, int count, const char *name) {
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (!strcmp(names[i], name))
+            return i;
+    return -1;
+}
+
+static void Dispatch(void) {
+    unsigned char event, before;
+
+    while ((event = EventGet()) != EV_NONE) {
+        before = LockState();
+        LockDispatch(event);
+        if (LockState() != before)
+            printf("%7ld ms  %-8s %s -> %s\n", now, events[event], states[before], states[LockState()]);
+    }
+}
+
+static unsigned char Queue(int event) {
+    return event == EV_KEY_VALID || event == EV_KEY_INVALID ? EVQ_HIGH : EVQ_MAIN;
+}
+
+static void Post(const char *line) {
+    char copy[256], *tok;
+    int event = -1, n;
+
+    strncpy(copy, line, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+    strtok(copy, " \t\n");
+    while ((tok = strtok(NULL, " \t\n")) != NULL) {
+        if (tok[0] == 'x' && event > 0) {
+            for (n = atoi(tok + 1) - 1; n > 0; n--)
+                EventPost(Queue(event), event);
+        } else if (!strchr(tok, '=')) {
+            event = Lookup(events, EV_COUNT, tok);
+            if (event <= 0 || event == EV_TIMEOUT) {
+                Fail(line, "unknown event", tok);
+                continue;
+            }
+            EventPost(Queue(event), event);
+        }
+    }
+}
+
+static void Check(const char *line) {
+    char copy[256], got[32], *tok, *value;
+    long want, have;
+
+    strncpy(copy, line, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+    strtok(copy, " \t\n");
+    while ((tok = strtok(NULL, " \t\n")) != NULL) {
+        if ((value = strchr(tok, '=')) == NULL)
+            continue;
+        *value++ = 0;
+        if (!strcmp(tok, "state")) {
+            if (strcmp(value, states[LockState()]))
+                Fail(line, tok, states[LockState()]);
+            continue;
+        }
+        if (!strcmp(tok, "bolt")) {
+            if (strcmp(value, moves[lastMove]))
+                Fail(line, tok, moves[lastMove]);
+            continue;
+        }
+        want = atol(value);
+        if (!strcmp(tok, "ignored"))
+            have = LockIgnored;
+        else if (!strcmp(tok, "overflows"))
+            have = EventOverflows[EVQ_HIGH] + EventOverflows[EVQ_LOW] + EventOverflows[EVQ_MAIN];
+        else {
+            Fail(line, "unknown check", tok);
+            continue;
+        }
+        if (have != want) {
+            sprintf(got, "%ld", have);
+            Fail(line, tok, got);
+        }
+    }
+}
+
+// As many bad swipes as an unsigned char counts, then a good card
+static void Saturate(void) {
+    int i;
+
+    EventInit();
+    LockInit();
+    for (i = 0; i < 256; i++, now++) {
+        EventPost(EVQ_HIGH, EV_KEY_INVALID);
+        if (now % LOCK_TICK_MS == 0)
+            LockTick();
+        Dispatch();
+    }
+    EventPost(EVQ_HIGH, EV_KEY_VALID);
+    Dispatch();
+    printf("256 bad swipes: fails %u, %s, card %s\n", LockFails, states[LockState()],
+            LockIgnored == 1 ? "ignored" : "let in");
+    if (LockFails != LOCK_MAX_FAILS || LockState() != LOCK_LOCKED || LockIgnored != 1) {
+        errors++;
+        printf("  ** still locked out expected, fails %d\n", LOCK_MAX_FAILS);
+    }
+}
+
+int main(int argc, char **argv) {
+    static char text[1000][256];
+    const char *lines[1001];
+    int n = 0, next = 0;
+    long due;
+    FILE *f;
+
+    if (argc > 1) {
+        if ((f = fopen(argv[1], "r")) == NULL) {
+            perror(argv[1]);
+            return 2;
+        }
+        while (n < 1000 && fgets(text[n], sizeof(text[n]), f))
+            if (text[n][0] != '#' && text[n][0] != '\n')
+                lines[n] = text[n], n++;
+        fclose(f);
+        lines[n] = NULL;
+    } else {
+        for (; builtIn[n]; n++)
+            lines[n] = builtIn[n];
+        lines[n] = NULL;
+    }
+
+    EventInit();
+    LockInit();
+    for (now = 0; lines[next]; now++) {
+        while (lines[next] && lines[next][0] == '#')
+            printf("%s\n", lines[next++]);
+        if (!lines[next])
+            break;
+        due = atol(lines[next]);
+        if (due < now) {
+            Fail(lines[next++], "line out of order", "");
+            continue;
+        }
+        if (due == now)
+            Post(lines[next]);
+        if (now % LOCK_TICK_MS == 0)
+            LockTick();
+        Dispatch();
+        if (due == now)
+            Check(lines[next++]);
+    }
+
+    printf("\n%ld ms, %u events ignored by guards, overflows high %u low %u main %u, %d errors\n",
+            now, LockIgnored, EventOverflows[EVQ_HIGH], EventOverflows[EVQ_LOW],
+            EventOverflows[EVQ_MAIN], errors);
+    Saturate();
+    printf("\n%d errors\n", errors);
+    return errors != 0;
+}
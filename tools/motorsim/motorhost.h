@@ -0,0 +1,31 @@
+/*********************************************************************
+ * FileName:        motorhost.h
+ * Processor:       Host (gcc)
+ *
+ * Stand-ins for the PIC18F4520 registers Motor Module.c touches, so
+ * it can be built with gcc and driven by motorsim.c.  They are plain
+ * variables, the model reads the duty back out of them after every
+ * tick.
+ ********************************************************************/
+
+#ifndef __MOTORHOST_H
+#define __MOTORHOST_H
+
+#define rom
+
+typedef struct {
+    unsigned char RC0 : 1;
+    unsigned char RC1 : 1;
+    unsigned char RC2 : 1;
+    unsigned char RC3 : 1;
+    unsigned char RC4 : 1;
+    unsigned char RC5 : 1;
+    unsigned char RC6 : 1;
+    unsigned char RC7 : 1;
+} HostTRISCbits_t;
+
+extern volatile unsigned char CCPR1L, CCP1CON, CCPR2L, CCP2CON;
+extern volatile unsigned char PR2, T2CON;
+extern volatile HostTRISCbits_t TRISCbits;
+
+#endif
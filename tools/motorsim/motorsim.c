@@ -0,0 +1,164 @@
+/*********************************************************************
+ * FileName:        motorsim.c
+ * Processor:       Host (gcc)
+ *
+ * Runs Motor Module.c tick by tick through a script of MotorSet()
+ * calls and checks the duty cycles it leaves in CCP1/CCP2:
+ *
+ *   - only one CCP ever has a non zero duty (the bridge never sees
+ *     both inputs driven)
+ *   - a direction change only happens once the duty has reached 0
+ *   - no step is bigger than the ramp tables allow, and the duty
+ *     only moves every MOTOR_RAMP_MS
+ *   - every target is reached, with the duty the speed asks for
+ *
+ *   gcc -Wall -I tools/motorsim -I MechatronicsProjectOfDoom.X -o motorsim \
+ *       tools/motorsim/motorsim.c "MechatronicsProjectOfDoom.X/Motor Module.c"
+ *   ./motorsim [-v]
+ *
+ * -v prints every duty change.  -DCLOCK_FOSC=32000000UL (or 8 or 16
+ * MHz) checks the PWM scaling at the other clocks.
+ *
+ * It finishes with what the motor costs the CPU against the old main
+ * loop, which polled RC6/RC7 and rewrote RC1/RC2 on every pass.  The
+ * cycle figures are estimates of what C18 makes of each path.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Motor Module.h"
+
+volatile unsigned char CCPR1L, CCP1CON, CCPR2L, CCP2CON;
+volatile unsigned char PR2, T2CON;
+volatile HostTRISCbits_t TRISCbits;
+
+// Estimated instruction cycles per path
+#define TCY_OLD_PASS    14      // old loop: 2 pin tests, 2 bit writes, branch back
+#define TCY_TICK        8       // MotorRampISR() call and divider, no step
+#define TCY_STEP        70      // ... with a step: table read, clamp, 16 bit product, 2 writes
+#define TCY_TASK        30      // taskMotor(): 2 pin tests and MotorSet()
+
+typedef struct {
+    long ms;
+    char direction;
+    unsigned char speed;
+    const char *what;
+} Command_t;
+
+static const Command_t script[] = {
+    {0, MOTOR_FORWARD, 200, "forward 200"},
+    {1500, MOTOR_FORWARD, 255, "forward full"},
+    {2500, MOTOR_FORWARD, 0, "stop"},
+    {3500, MOTOR_REVERSE, 200, "reverse 200"},
+    {5000, MOTOR_FORWARD, 200, "forward 200 (turn round)"},
+    {5300, MOTOR_REVERSE, 100, "reverse 100 (before the turn finished)"},
+    {7000, MOTOR_REVERSE, 40, "reverse 40"},
+    {8000, MOTOR_REVERSE, 0, "stop"},
+    {9000, MOTOR_FORWARD, 1, "forward 1"},
+    {10000, MOTOR_FORWARD, 0, "stop"},
+    {11000, -1, 0, NULL}
+};
+
+static int errors;
+static long now;
+
+static unsigned int Duty(unsigned char ccprl, unsigned char ccpcon) {
+    return (unsigned int) ccprl << 2 | (ccpcon >> 4 & 3);
+}
+
+static void Error(const char *what, unsigned int d1, unsigned int d2) {
+    if (errors++ < 20)
+        printf("  ** %ld ms: %s (CCP1 %u, CCP2 %u)\n", now, what, d1, d2);
+}
+
+int main(int argc, char **argv) {
+    char verbose = argc > 1 && !strcmp(argv[1], "-v");
+    unsigned int full = 4 * (CLOCK_PR2 + 1);
+    unsigned int maxStep = 0, d1, d2, last1 = 0, last2 = 0, step;
+    long lastChange = -MOTOR_RAMP_MS, started = 0, steps = 0, ticks = 0;
+    unsigned long tcy;
+    char lastActive = -1, active, reached = 1;
+    const Command_t *c = script;
+    int i;
+
+    for (i = 0; i < MOTOR_BANDS; i++) {
+        if (motorAccel[i] > maxStep)
+            maxStep = motorAccel[i];
+        if (motorDecel[i] > maxStep)
+            maxStep = motorDecel[i];
+    }
+    maxStep = (maxStep * (CLOCK_PR2 + 1) + 63) / 64; // in duty counts
+
+    printf("%lu MHz, PWM %lu Hz, %u duty steps, ramp step every %d ms\n\n",
+            CLOCK_FOSC / 1000000, 1000000UL / CLOCK_T2_US, full, MOTOR_RAMP_MS);
+    MotorInit();
+    if (PR2 != CLOCK_PR2 || (CCP1CON & 0x0F) != 0x0C || (CCP2CON & 0x0F) != 0x0C
+            || TRISCbits.RC1 || TRISCbits.RC2)
+        Error("MotorInit() left the PWM set up wrong", CCP1CON, CCP2CON);
+
+    for (now = 0; c->direction >= 0 || now < c->ms; now++) {
+        if (c->direction >= 0 && now == c->ms) {
+            if (!reached)
+                printf("    (replaced before it got there)\n");
+            printf("%6ld ms  %s\n", now, c->what);
+            MotorSet(c->direction, c->speed);
+            started = now;
+            reached = 0;
+            c++;
+        }
+        if (c->direction < 0 && now >= c->ms)
+            break;
+
+        MotorRampISR();
+        ticks++;
+        d1 = Duty(CCPR1L, CCP1CON);
+        d2 = Duty(CCPR2L, CCP2CON);
+        if (d1 == last1 && d2 == last2) {
+            c--;
+            if (!reached && MotorDirection() == c->direction && MotorSpeed() == c->speed) {
+                printf("    there after %ld ms, duty %u/%u\n", now - started, d1 + d2, full);
+                if (d1 + d2 != (unsigned int) c->speed * (CLOCK_PR2 + 1) / 64)
+                    Error("wrong duty for the speed", d1, d2);
+                reached = 1;
+            }
+            c++;
+            continue;
+        }
+
+        steps++;
+        if (verbose)
+            printf("%6ld ms  CCP1 %4u  CCP2 %4u  speed %3u\n", now, d1, d2, MotorSpeed());
+        if (d1 && d2)
+            Error("both CCPs driven", d1, d2);
+        if (CCP1CON >> 6 || CCP2CON >> 6 || (CCP1CON & 0x0F) != 0x0C || (CCP2CON & 0x0F) != 0x0C)
+            Error("CCPxCON mode bits changed", d1, d2);
+        step = d1 > last1 ? d1 - last1 : last1 - d1;
+        step += d2 > last2 ? d2 - last2 : last2 - d2;
+        if (step > maxStep)
+            Error("step bigger than the ramp tables allow", d1, d2);
+        if (now - lastChange < MOTOR_RAMP_MS)
+            Error("stepped sooner than MOTOR_RAMP_MS", d1, d2);
+        active = d1 ? MOTOR_FORWARD : d2 ? MOTOR_REVERSE : lastActive;
+        if (lastActive >= 0 && active != lastActive && (last1 || last2))
+            Error("changed direction without stopping", d1, d2);
+        if (active != MotorDirection() && (d1 || d2))
+            Error("duty on the wrong CCP for the direction", d1, d2);
+        lastActive = active;
+        lastChange = now;
+        last1 = d1;
+        last2 = d2;
+    }
+    if (!reached)
+        Error("last target never reached", last1, last2);
+
+    printf("\n%ld ticks, %ld duty changes, %d errors\n", ticks, steps, errors);
+    printf("\nCPU per second (estimated):\n");
+    printf("  old loop, polling on every pass  %5d cycles a pass, all the loop had time for\n",
+            TCY_OLD_PASS);
+    tcy = (ticks * TCY_TICK + steps * TCY_STEP) * 1000 / ticks;
+    printf("  ramp in the scheduler tick       %5lu cycles  %5.2f%%\n", tcy,
+            tcy * 100.0 / (CLOCK_FOSC / 4));
+    printf("  taskMotor() every 20 ms          %5d cycles  %5.2f%%\n", TCY_TASK * 50,
+            TCY_TASK * 50 * 100.0 / (CLOCK_FOSC / 4));
+    return errors != 0;
+}
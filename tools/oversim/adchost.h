@@ -0,0 +1,50 @@
+/*********************************************************************
+ * FileName:        adchost.h
+ * Processor:       Host (gcc)
+ *
+ * Stand-ins for the PIC18F4520 registers ADC Module.c touches, so it
+ * can be built with gcc and driven by oversim.c and tools/adcscan.  The
+ * model plays the converter: it sees GO set, puts a result in ADRESH/
+ * ADRESL, clears GO and calls ADCSampleISR().  Apart from ADCON0 the
+ * byte registers and their ...bits aren't the same memory here, T3CON =
+ * ... in ADCSampleInit() doesn't set T3CONbits.TMR3ON, the model has to.
+ ********************************************************************/
+
+#ifndef __ADCHOST_H
+#define __ADCHOST_H
+
+#define rom
+
+typedef union {
+    struct {
+        unsigned char ADON : 1;
+        unsigned char GO : 1;
+        unsigned char CHS : 4;
+    };
+    unsigned char byte;
+} HostADCON0_t; // ADCON0 and ADCON0bits, the one register
+
+typedef struct {
+    unsigned char ADIF : 1, ADIE : 1, ADIP : 1;
+} HostPIR1bits_t; // PIR1bits, PIE1bits and IPR1bits, only the ADC bits
+
+typedef struct {
+    unsigned char TMR3IF : 1, TMR3IE : 1, TMR3IP : 1;
+} HostPIR2bits_t; // PIR2bits, PIE2bits and IPR2bits, only the Timer3 bits
+
+typedef struct {
+    unsigned char TMR3ON : 1;
+} HostT3CONbits_t;
+
+extern volatile unsigned char ADRESH, ADRESL, ADCON1, ADCON2, TMR3H, TMR3L, T3CON;
+extern volatile HostADCON0_t HostADCON0;
+#define ADCON0bits HostADCON0
+#define ADCON0 HostADCON0.byte
+extern volatile HostPIR1bits_t PIR1bits, PIE1bits, IPR1bits;
+extern volatile HostPIR2bits_t PIR2bits, PIE2bits, IPR2bits;
+extern volatile HostT3CONbits_t T3CONbits;
+
+// ADC_CLOCK and the rest are <adc.h> names, never expanded here
+#define OpenADC(config, config2, portconfig) (ADCON1 = (portconfig), ADCON2 = 0x2A)
+
+#endif
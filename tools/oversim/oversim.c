@@ -0,0 +1,193 @@
+/*********************************************************************
+ * FileName:        oversim.c
+ * Processor:       Host (gcc)
+ *
+ * Runs ADC Module.c's oversampling on synthetic noisy signals, with a
+ * model converter behind the registers (adchost.h), and checks what it
+ * buys:
+ *
+ *   resolution  a slow ramp over 10 LSB, 1/64 LSB a step, with Gaussian
+ *               noise on every conversion.  The RMS error of the samples
+ *               against the true level, next to that of single 10 bit
+ *               conversions, has to come down by 2^N (N bits) give or
+ *               take a quarter of a bit, with no bias to speak of.
+ *   steps       distinct sample values inside one 10 bit LSB, at least
+ *               2^N with noise, and just 1 without (no dither, no gain).
+ *   chatter     a level 0.75 LSB above IR_EXIT, how often a sample still
+ *               comes out at or below it.
+ *   bursts      every sample is exactly ADC_BURST conversions and bumps
+ *               the sequence number by one.
+ *
+ * then what it costs, from estimated cycle counts for each path.
+ *
+ *   gcc -Wall -I tools/oversim -I MechatronicsProjectOfDoom.X -o oversim \
+ *       tools/oversim/oversim.c "MechatronicsProjectOfDoom.X/ADC Module.c" -lm
+ *   ./oversim [noise]          (RMS noise in 10 bit LSB, 0.6 by default)
+ *
+ * -DADC_OVERSAMPLE_BITS=0 (to 3) and -DCLOCK_FOSC=32000000UL try the
+ * other settings, the same #errors as on the PIC stop the ones that
+ * don't fit.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "adchost.h"
+#include "ADC Module.h"
+#include "IR Module.h"
+
+volatile unsigned char ADRESH, ADRESL, ADCON1, ADCON2, TMR3H, TMR3L, T3CON;
+volatile HostADCON0_t HostADCON0;
+volatile HostPIR1bits_t PIR1bits, PIE1bits, IPR1bits;
+volatile HostPIR2bits_t PIR2bits, PIE2bits, IPR2bits;
+volatile HostT3CONbits_t T3CONbits;
+
+// Estimated instruction cycles per path, on top of ADC_ISR_TCY for
+// each conversion (high_isr in and out, the tests ahead of the ADC one,
+// adding the result up and setting GO)
+#define TCY_TIMER       45      // high_isr with ADCTimerISR(): reload, GO
+#define TCY_PUBLISH     32      // end of the burst: round, shift, swap halves, IR ring
+#define TCY_SHIFT       4       // each bit of the 16 bit shift
+
+#define STEPS           64      // ramp steps per LSB
+#define REPEAT          16      // samples at each step
+
+static double noise = 0.6;
+static unsigned int now; // ClockStamp(), time doesn't matter here
+static unsigned long seed = 1, conversions, samples;
+static int errors;
+
+static double Uniform(void) {
+    seed = seed * 1103515245UL + 12345UL;
+    return ((seed >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+static double Gauss(void) {
+    double u = Uniform() + 1e-12;
+
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * Uniform());
+}
+
+// One 10 bit conversion of level x (in LSB), transitions half way between codes
+static int Convert(double x, double sigma) {
+    int code = (int) floor(x + sigma * Gauss() + 0.5);
+
+    return code < 0 ? 0 : code > 1023 ? 1023 : code;
+}
+
+// One Timer3 overflow and the burst of conversions it starts, in 10 bit LSB
+static double Sample(double x, double sigma) {
+    static unsigned char last;
+    unsigned long before = conversions;
+    unsigned char seq;
+    int value, code;
+
+    PIR2bits.TMR3IF = 1;
+    ADCTimerISR();
+    while (ADCON0bits.GO) {
+        code = Convert(x, sigma);
+        ADRESH = code >> 8;
+        ADRESL = code & 0xFF;
+        ADCON0bits.GO = 0;
+        PIR1bits.ADIF = 1;
+        ADCSampleISR();
+        conversions++;
+    }
+    seq = ADCLatest(&value);
+    if ((conversions - before != ADC_BURST || seq != (unsigned char) (last + 1)) && errors++ < 10)
+        printf("  ** burst of %lu conversions, seq %u after %u\n", conversions - before, seq, last);
+    if (ADCBusy() && errors++ < 10)
+        printf("  ** still busy after the burst\n");
+    last = seq;
+    samples++;
+    return (double) value / (1 << ADC_OVERSAMPLE_BITS);
+}
+
+unsigned int ClockStamp(void) {
+    return now;
+}
+
+static void Check(int ok, const char *what) {
+    if (!ok) {
+        errors++;
+        printf("  ** %s\n", what);
+    }
+}
+
+// Distinct sample values (seen at least REPEAT times, the odd outlier
+// doesn't count) while the level crosses the 10 bit code 600
+static int Steps(double sigma) {
+    int seen[64] = {0};
+    int i, j, n = 0, v;
+
+    for (i = 0; i < STEPS; i++)
+        for (j = 0; j < REPEAT; j++) {
+            v = (int) floor(Sample(599.5 + (i + 0.5) / STEPS, sigma) * (1 << ADC_OVERSAMPLE_BITS) + 0.5)
+                    - (600 << ADC_OVERSAMPLE_BITS) + 16;
+            if (v >= 0 && v < 64)
+                seen[v]++;
+        }
+    for (i = 0; i < 64; i++)
+        if (seen[i] >= REPEAT)
+            n++;
+    return n;
+}
+
+int main(int argc, char **argv) {
+    double x, e, over = 0, single = 0, bias = 0, gain;
+    long n = 0, low1 = 0, lowN = 0, i;
+    unsigned long tcy;
+    int steps0, stepsN;
+
+    if (argc > 1)
+        noise = atof(argv[1]);
+    ADCSampleInit();
+
+    printf("%lu MHz, %d bit samples from %d conversions, noise %.2f LSB RMS\n",
+            CLOCK_FOSC / 1000000, ADC_BITS, ADC_BURST, noise);
+    printf("AN0: %lu samples/s, %lu conversions/s, burst %lu us of every %d us\n\n",
+            ADC_SAMPLE_HZ, ADC_CONVERT_HZ, ADC_BURST_US, ADC_SAMPLE_US);
+
+    for (x = 500.0; x < 510.0; x += 1.0 / STEPS)
+        for (i = 0; i < REPEAT; i++) {
+            e = Sample(x, noise) - x;
+            over += e * e;
+            bias += e;
+            e = Convert(x, noise) - x;
+            single += e * e;
+            n++;
+        }
+    over = sqrt(over / n);
+    single = sqrt(single / n);
+    bias /= n;
+    gain = log(single / over) / log(2);
+    printf("resolution  RMS error %.3f LSB, single conversions %.3f, gain %.2f bits, bias %+.3f\n",
+            over, single, gain, bias);
+    Check(gain > ADC_OVERSAMPLE_BITS - 0.25, "less resolution gained than ADC_OVERSAMPLE_BITS");
+    Check(fabs(bias) < 0.5 / (1 << ADC_OVERSAMPLE_BITS), "biased by more than half a sample step");
+
+    stepsN = Steps(noise);
+    steps0 = Steps(0);
+    printf("steps       %d values per LSB with noise, %d without\n", stepsN, steps0);
+    Check(stepsN >= 1 << ADC_OVERSAMPLE_BITS, "fewer than 2^N values per LSB with noise");
+    Check(steps0 == 1, "noise free input gave more than one value per LSB");
+
+    for (i = 0; i < 10000; i++) {
+        if (Sample(1000.75, noise) * (1 << ADC_OVERSAMPLE_BITS) <= IR_EXIT)
+            lowN++;
+        if (Convert(1000.75, noise) <= 1000)
+            low1++;
+    }
+    printf("chatter     at IR_EXIT + 0.75 LSB, %.1f%% of samples at or below it, %.1f%% of"
+            " single conversions\n", lowN / 100.0, low1 / 100.0);
+
+    printf("bursts      %lu samples, %lu conversions\n", samples, conversions);
+
+    tcy = TCY_TIMER + ADC_BURST * ADC_ISR_TCY + (ADC_OVERSAMPLE_BITS ? TCY_PUBLISH : 0)
+            + ADC_OVERSAMPLE_BITS * TCY_SHIFT;
+    printf("\nCPU (estimated): %lu cycles a sample, %lu a second, %.1f%% at %lu MHz\n",
+            tcy, tcy * ADC_SAMPLE_HZ, tcy * ADC_SAMPLE_HZ * 100.0 / (CLOCK_FOSC / 4),
+            CLOCK_FOSC / 1000000);
+    printf("\n%d errors\n", errors);
+    return errors != 0;
+}
@@ -0,0 +1,222 @@
+/*********************************************************************
+ * FileName:        schedtest.c
+ * Processor:       Host (gcc)
+ *
+ * Runs Scheduler Module.c on a simulated tick (SchedTick(), as the host
+ * build has no Timer0) and checks:
+ *
+ *   period/phase   each task first runs phase ticks after SchedAdd()
+ *                  and then every period, with several tasks due on the
+ *                  same ticks
+ *   SCHED_FULL     the task after SCHED_MAX_TASKS is refused and the
+ *                  ones already in keep running
+ *   priority       tasks due together run lowest priority number first,
+ *                  equal priorities in the order they were added, one
+ *                  per SchedRun()
+ *   overruns       a task held up for whole periods counts them once
+ *                  each time and picks up from now, it doesn't run the
+ *                  missed ones back to back
+ *   wrap           all of the above again with the tick counter started
+ *                  just short of wrapping round
+ *
+ *   gcc -Wall -I MechatronicsProjectOfDoom.X -o schedtest \
+ *       tools/schedtest/schedtest.c "MechatronicsProjectOfDoom.X/Scheduler Module.c"
+ *   ./schedtest
+ *
+ * The tick counter is an unsigned int, 32 bits here against 16 on the
+ * PIC.  The wrap run starts it just short of the host's wrap; the
+ * (short) differences in SchedRun() do the same sums at either width.
+ ********************************************************************/
+
+#include <stdio.h>
+#include "Scheduler Module.h"
+
+extern volatile unsigned int _vSchedTicks;
+
+#define TICKS           1000    // ticks run by each check
+#define MAX_RUNS        4000
+
+static unsigned int runTick[SCHED_MAX_TASKS + 1][MAX_RUNS];
+static int runs[SCHED_MAX_TASKS + 1];
+static int order[SCHED_MAX_TASKS * 4], orders;
+static int errors;
+static unsigned int start;
+static int holdTicks; // task 0 takes this many ticks on its next run
+
+static void Error(const char *what, long a, long b) {
+    if (errors++ < 20)
+        printf("  ** %s (%ld, %ld)\n", what, a, b);
+}
+
+static void Ran(int id) {
+    if (runs[id] < MAX_RUNS)
+        runTick[id][runs[id]++] = SchedNow() - start;
+    if (orders < (int) (sizeof order / sizeof order[0]))
+        order[orders++] = id;
+}
+
+static void Task0(void) {
+    Ran(0);
+    while (holdTicks > 0) { // a task that hogs the CPU, the tick goes on underneath
+        SchedTick();
+        holdTicks--;
+    }
+}
+static void Task1(void) { Ran(1); }
+static void Task2(void) { Ran(2); }
+static void Task3(void) { Ran(3); }
+static void Task4(void) { Ran(4); }
+static void Task5(void) { Ran(5); }
+static void Task6(void) { Ran(6); }
+static void Task7(void) { Ran(7); }
+static void Task8(void) { Ran(8); }
+static void Task9(void) { Ran(9); }
+static void Task10(void) { Ran(10); }
+
+static void (*const tasks[SCHED_MAX_TASKS + 1])(void) = {
+    Task0, Task1, Task2, Task3, Task4, Task5, Task6, Task7, Task8, Task9, Task10
+};
+
+static void Start(unsigned int ticks) {
+    int i;
+
+    SchedInit();
+    _vSchedTicks = ticks;
+    start = ticks;
+    for (i = 0; i <= SCHED_MAX_TASKS; i++)
+        runs[i] = 0;
+    orders = 0;
+    holdTicks = 0;
+}
+
+// Runs everything due, then moves time on a tick, up to tick end of this check.
+// No task is due twice in a tick, more runs than tasks is a scheduler stuck
+// on a due time it has already passed
+static void RunUntil(unsigned int end) {
+    int n;
+
+    while (SchedNow() - start < end) {
+        for (n = 0; SchedRun(); n++)
+            if (n == SCHED_MAX_TASKS) {
+                Error("SchedRun() keeps running on one tick", SchedNow() - start, n);
+                return;
+            }
+        SchedTick();
+    }
+}
+
+// Runs of task id at phase, phase + period, ... up to the end of the run
+static void Expect(int id, unsigned int period, unsigned int phase, unsigned int end) {
+    int k, n = 0;
+
+    for (k = 0; k < runs[id]; k++)
+        if (runTick[id][k] != phase + k * period) {
+            Error("run on the wrong tick", id, runTick[id][k]);
+            return;
+        }
+    if (phase < end)
+        n = (end - 1 - phase) / period + 1;
+    if (runs[id] != n)
+        Error("wrong number of runs", id, runs[id]);
+}
+
+static void CheckPeriods(unsigned int from) {
+    static const unsigned int period[6] = {1, 3, 7, 10, 100, 250};
+    static const unsigned int phase[6] = {0, 2, 0, 5, 50, 249};
+    int i;
+
+    Start(from);
+    for (i = 0; i < 6; i++)
+        if (SchedAdd(tasks[i], period[i], phase[i], (unsigned char) i) != i)
+            Error("SchedAdd() id", i, 0);
+    RunUntil(TICKS);
+    for (i = 0; i < 6; i++) {
+        Expect(i, period[i], phase[i], TICKS);
+        if (SchedOverruns((unsigned char) i))
+            Error("overrun counted", i, SchedOverruns((unsigned char) i));
+    }
+}
+
+static void CheckFull(unsigned int from) {
+    int i;
+
+    Start(from);
+    for (i = 0; i < SCHED_MAX_TASKS; i++)
+        if (SchedAdd(tasks[i], 10, (unsigned int) i, 0) != i)
+            Error("SchedAdd() refused a task with room", i, 0);
+    if (SchedAdd(tasks[SCHED_MAX_TASKS], 1, 0, 0) != SCHED_FULL)
+        Error("SchedAdd() past SCHED_MAX_TASKS", SCHED_MAX_TASKS, 0);
+    RunUntil(TICKS);
+    for (i = 0; i < SCHED_MAX_TASKS; i++)
+        Expect(i, 10, (unsigned int) i, TICKS);
+    if (runs[SCHED_MAX_TASKS])
+        Error("refused task ran", SCHED_MAX_TASKS, runs[SCHED_MAX_TASKS]);
+    if (SchedOverruns(SCHED_FULL))
+        Error("SchedOverruns(SCHED_FULL)", 0, SchedOverruns(SCHED_FULL));
+}
+
+static void CheckPriority(unsigned int from) {
+    // id: priority, all due on the same ticks
+    static const unsigned char prio[5] = {3, 1, 2, 1, 0};
+    static const int want[5] = {4, 1, 3, 2, 0};
+    int i;
+
+    Start(from);
+    for (i = 0; i < 5; i++)
+        SchedAdd(tasks[i], 4, 2, prio[i]);
+    SchedTick();
+    SchedTick();
+    for (i = 0; i < 5; i++) {
+        if (!SchedRun())
+            Error("due task didn't run", i, 0);
+        if (orders != i + 1)
+            Error("SchedRun() ran more than one", i, orders);
+    }
+    if (SchedRun())
+        Error("ran with nothing due", 0, 0);
+    for (i = 0; i < 5; i++)
+        if (order[i] != want[i])
+            Error("priority order", i, order[i]);
+}
+
+static void CheckOverruns(unsigned int from) {
+    Start(from);
+    SchedAdd(tasks[0], 5, 0, 0);
+    SchedAdd(tasks[1], 10, 0, 1);
+    RunUntil(20); // 0 5 10 15 and 0 10
+    holdTicks = 23; // the run on tick 20 takes until 43
+    RunUntil(45);
+    // task 0, due at 25, and task 1, due at 20, both run at 43, a period or more
+    // late: one overrun each, next due 48 and 53
+    if (SchedOverruns(0) != 1 || SchedOverruns(1) != 1)
+        Error("overruns after a hold up", SchedOverruns(0), SchedOverruns(1));
+    if (runs[0] != 6 || runTick[0][4] != 20 || runTick[0][5] != 43)
+        Error("task 0 after the hold up", runs[0], runs[0] > 5 ? runTick[0][5] : 0);
+    if (runs[1] != 3 || runTick[1][2] != 43)
+        Error("task 1 after the hold up", runs[1], runs[1] > 2 ? runTick[1][2] : 0);
+    RunUntil(60); // back on the new phase: 48 53 58 and 53
+    if (runs[0] != 9 || runTick[0][6] != 48 || runTick[0][8] != 58 || runs[1] != 4 || runTick[1][3] != 53)
+        Error("didn't pick up after the hold up", runs[0], runs[1]);
+    if (SchedOverruns(0) != 1 || SchedOverruns(1) != 1)
+        Error("overruns counted again", SchedOverruns(0), SchedOverruns(1));
+}
+
+static void Check(const char *name, unsigned int from) {
+    int before = errors;
+
+    CheckPeriods(from);
+    CheckFull(from);
+    CheckPriority(from);
+    CheckOverruns(from);
+    printf("%-26s %s\n", name, errors == before ? "ok" : "** wrong");
+}
+
+int main(void) {
+    printf("%d tasks at most, %u us tick\n\n", SCHED_MAX_TASKS, SCHED_TICK_US);
+    Check("from 0", 0);
+    Check("from 100 short of a wrap", 0u - 100);
+    Check("from 1 short of a wrap", 0u - 1);
+    Check("from 32767", 32767);
+    printf("\n%d errors\n", errors);
+    return errors != 0;
+}
@@ -0,0 +1,185 @@
+/*********************************************************************
+ * FileName:        seqgen.c
+ * Processor:       Host (gcc)
+ *
+ * Compiles button sequences into the ROM tables Sequence Module.c
+ * steps through, one lookup per key press:
+ *
+ *   gcc -Wall -o seqgen tools/seqgen/seqgen.c
+ *   ./seqgen abbc bcaa acac > "MechatronicsProjectOfDoom.X/Sequence Table.c"
+ *
+ * Sequence n (from 1, in the order given) is bit n-1 of the match mask,
+ * up to 8 of them, over the keys 'a' to 'a' + SEQ_SYMBOLS - 1.
+ *
+ * The tables are an Aho-Corasick automaton with the failure links
+ * folded in, so every state has a next state for every key and nothing
+ * has to be remembered between presses except the state.  A state's
+ * mask includes every sequence that ends there, also the ones that are
+ * a suffix of a longer one (bc inside abc).
+ *
+ * Before printing, the tables are run against a brute force match of
+ * the last presses over a long random stream and the program stops if
+ * they ever disagree.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SEQ_SYMBOLS 3           // keys 'a' 'b' 'c', same as Sequence Module.h
+#define MAX_SEQS    8
+#define MAX_LEN     32
+#define MAX_STATES  255
+
+static int next[MAX_STATES][SEQ_SYMBOLS];
+static int fail[MAX_STATES];
+static unsigned char mask[MAX_STATES];
+static int states = 1;
+
+static const char *seqs[MAX_SEQS];
+static int nseqs;
+
+static void Add(const char *s, int bit) {
+    int st = 0;
+
+    for (; *s; s++) {
+        int k = *s - 'a';
+        if (!next[st][k]) {
+            if (states == MAX_STATES) {
+                fprintf(stderr, "more than %d states\n", MAX_STATES);
+                exit(1);
+            }
+            next[st][k] = states++;
+        }
+        st = next[st][k];
+    }
+    mask[st] |= 1 << bit;
+}
+
+// Breadth first, filling in the missing transitions from the failure links
+static void Build(void) {
+    int queue[MAX_STATES], head = 0, tail = 0;
+    int k, st, child;
+
+    for (k = 0; k < SEQ_SYMBOLS; k++) {
+        if (next[0][k]) {
+            fail[next[0][k]] = 0;
+            queue[tail++] = next[0][k];
+        }
+    }
+    while (head < tail) {
+        st = queue[head++];
+        mask[st] |= mask[fail[st]];
+        for (k = 0; k < SEQ_SYMBOLS; k++) {
+            child = next[st][k];
+            if (child) {
+                fail[child] = next[fail[st]][k];
+                queue[tail++] = child;
+            } else
+                next[st][k] = next[fail[st]][k];
+        }
+    }
+}
+
+static unsigned char Brute(const char *hist, int n) {
+    unsigned char m = 0;
+    int i, len;
+
+    for (i = 0; i < nseqs; i++) {
+        len = strlen(seqs[i]);
+        if (len <= n && !memcmp(hist + n - len, seqs[i], len))
+            m |= 1 << i;
+    }
+    return m;
+}
+
+static void Verify(void) {
+    static char hist[200000];
+    int i, st = 0;
+    unsigned long hits = 0;
+
+    srand(1);
+    for (i = 0; i < (int) sizeof (hist); i++) {
+        // Mostly random, every so often one of the sequences on purpose
+        if (rand() % 8 == 0 && i + MAX_LEN < (int) sizeof (hist)) {
+            const char *s = seqs[rand() % nseqs];
+            for (; *s; s++, i++) {
+                hist[i] = *s;
+                st = next[st][*s - 'a'];
+                if (mask[st] != Brute(hist, i + 1))
+                    goto bad;
+                hits += mask[st] != 0;
+            }
+            i--;
+            continue;
+        }
+        hist[i] = 'a' + rand() % SEQ_SYMBOLS;
+        st = next[st][hist[i] - 'a'];
+        if (mask[st] != Brute(hist, i + 1))
+            goto bad;
+        hits += mask[st] != 0;
+    }
+    fprintf(stderr, "%d states, checked against brute force over %d presses, %lu matches\n",
+            states, (int) sizeof (hist), hits);
+    return;
+bad:
+    fprintf(stderr, "table disagrees with brute force at press %d\n", i);
+    exit(1);
+}
+
+int main(int argc, char **argv) {
+    int i, k;
+    const char *p;
+
+    if (argc < 2 || argc - 1 > MAX_SEQS) {
+        fprintf(stderr, "usage: seqgen seq1 [seq2 ... seq%d]  (keys a-%c)\n", MAX_SEQS,
+                'a' + SEQ_SYMBOLS - 1);
+        return 1;
+    }
+    for (i = 1; i < argc; i++) {
+        if (!*argv[i] || strlen(argv[i]) > MAX_LEN) {
+            fprintf(stderr, "sequence %d: 1 to %d keys\n", i, MAX_LEN);
+            return 1;
+        }
+        for (p = argv[i]; *p; p++) {
+            if (*p < 'a' || *p >= 'a' + SEQ_SYMBOLS) {
+                fprintf(stderr, "sequence %d: '%c' is not a key\n", i, *p);
+                return 1;
+            }
+        }
+        seqs[nseqs] = argv[i];
+        Add(argv[i], nseqs++);
+    }
+    Build();
+    Verify();
+
+    printf("/*********************************************************************\n");
+    printf(" * FileName:        Sequence Table.c\n");
+    printf(" * Processor:       PIC18F4520\n");
+    printf(" * Compiler:        MPLAB C18 v.3.06\n");
+    printf(" *\n");
+    printf(" * Generated by tools/seqgen, don't edit.  Sequences:\n");
+    for (i = 0; i < nseqs; i++)
+        printf(" *   %d  %s\n", i + 1, seqs[i]);
+    printf(" ********************************************************************/\n\n");
+    printf("#include \"Sequence Module.h\"\n\n");
+    printf("#if SEQ_SYMBOLS != %d\n#error \"Sequence Table.c was generated for %d keys\"\n#endif\n\n",
+            SEQ_SYMBOLS, SEQ_SYMBOLS);
+    printf("rom unsigned char seqCount = %d;\n\n", nseqs);
+    printf("// Next state, [state * SEQ_SYMBOLS + key]\n");
+    printf("rom unsigned char seqNext[%d] = {\n", states * SEQ_SYMBOLS);
+    for (i = 0; i < states; i++) {
+        printf("    ");
+        for (k = 0; k < SEQ_SYMBOLS; k++)
+            printf("%3d,", next[i][k]);
+        printf(" // %d\n", i);
+    }
+    printf("};\n\n");
+    printf("// Sequences that end in each state, bit n-1 = sequence n\n");
+    printf("rom unsigned char seqMatch[%d] = {\n", states);
+    for (i = 0; i < states; i++)
+        printf("%s0x%02X,%s", i % 8 ? "" : "    ", mask[i],
+                (i % 8 == 7 || i == states - 1) ? "\n" : " ");
+    printf("};\n");
+    return 0;
+}
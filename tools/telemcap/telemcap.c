@@ -0,0 +1,125 @@
+/*********************************************************************
+ * FileName:        telemcap.c
+ * Processor:       Host (gcc)
+ *
+ * Reads IR telemetry records (Telemetry Module.h) from the serial port
+ * or a capture file and writes CSV, one reading per line:
+ *
+ *   sample,ms,value
+ *
+ * sample counts ADC samples from the first record, so readings the
+ * board never sent leave a jump in it; ms is sample * ADC_SAMPLE_US.
+ *
+ *   gcc -Wall -I MechatronicsProjectOfDoom.X -o telemcap tools/telemcap/telemcap.c
+ *   ./telemcap /dev/ttyUSB0 > ir.csv          (until ^C)
+ *   ./telemcap capture.bin > ir.csv
+ *
+ * value is in ADC_BITS units, build it with the same
+ * -DADC_OVERSAMPLE_BITS as the board or the records won't line up.
+ * A tty is set to SERIAL_BAUD raw first.  Records with a bad sum are
+ * skipped.  The totals go to stderr at the end, missing being the gaps
+ * in the record numbers: records the board had no room for or held
+ * back (see TelemetryDrops) plus the ones with bad sums.  The board's
+ * own TelemetryDrops and TelemetryGaps, from the records, go after
+ * them, as counted from the first record on.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <signal.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include "Telemetry Module.h"
+#include "Serial Module.h"
+#include "ADC Module.h"
+
+static volatile sig_atomic_t stop;
+
+static void Stop(int sig) {
+    (void) sig;
+    stop = 1;
+}
+
+static int Raw(int fd) {
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) < 0)
+        return -1;
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, SERIAL_BAUD == 38400 ? B38400 : B9600);
+    cfsetospeed(&tio, SERIAL_BAUD == 38400 ? B38400 : B9600);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio);
+}
+
+int main(int argc, char **argv) {
+    unsigned char r[TELEM_BYTES], lastDrops = 0, lastGaps = 0, sum, *g;
+    unsigned long lo;
+    long records = 0, bad = 0, missed = 0, sample = 0, est, drops = 0, gaps = 0;
+    int have = 0, i, j, seq = -1, adc = 0, fd = 0;
+    signed char d;
+    ssize_t n;
+
+    if (argc > 1 && (fd = open(argv[1], O_RDONLY | O_NOCTTY)) < 0) {
+        perror(argv[1]);
+        return 2;
+    }
+    if (isatty(fd) && Raw(fd) < 0) {
+        perror("termios");
+        return 2;
+    }
+    signal(SIGINT, Stop);
+    printf("sample,ms,value\n");
+
+    // r[] holds what might be the start of a record, shifted along a
+    // byte at a time until the sync bytes and the sum both check out
+    while (!stop) {
+        if ((n = read(fd, r + have, TELEM_BYTES - have)) <= 0)
+            break;
+        have += n;
+        while (have == TELEM_BYTES) {
+            for (sum = 0, i = 2; i < TELEM_BYTES - 1; i++)
+                sum += r[i];
+            if (r[0] != TELEM_SYNC1 || r[1] != TELEM_SYNC2 || sum != r[TELEM_BYTES - 1]) {
+                if (r[0] == TELEM_SYNC1 && r[1] == TELEM_SYNC2)
+                    bad++;
+                memmove(r, r + 1, --have);
+                continue;
+            }
+            if (seq >= 0) {
+                // Where this record should start going by the record
+                // numbers, moved by however far its ADC seq says it's off
+                missed += (unsigned char) (r[2] - seq - 1);
+                est = (unsigned char) (r[2] - seq) * TELEM_SAMPLES;
+                d = (signed char) (r[3] - (unsigned char) (adc + est));
+                sample += est + d;
+                drops += (unsigned char) (r[4] - lastDrops);
+                gaps += (unsigned char) (r[5] - lastGaps);
+            }
+            seq = r[2];
+            adc = r[3];
+            lastDrops = r[4];
+            lastGaps = r[5];
+            records++;
+            for (i = 0; i < TELEM_SAMPLES / 4; i++) {
+                g = r + 6 + (4 + TELEM_LOW_BYTES) * i;
+                for (lo = 0, j = TELEM_LOW_BYTES - 1; j >= 0; j--)
+                    lo = lo << 8 | g[4 + j];
+                for (j = 0; j < 4; j++)
+                    printf("%ld,%.3f,%lu\n", sample + 4 * i + j,
+                        (sample + 4 * i + j) * ADC_SAMPLE_US / 1000.0,
+                        (unsigned long) g[j] << TELEM_LOW_BITS
+                        | (lo >> (TELEM_LOW_BITS * j) & ((1 << TELEM_LOW_BITS) - 1)));
+            }
+            fflush(stdout);
+            have = 0;
+        }
+    }
+
+    fprintf(stderr, "%ld records (%ld readings), %ld bad sums, %ld missing\n",
+            records, records * TELEM_SAMPLES, bad, missed);
+    fprintf(stderr, "board: %ld drops, %ld gaps\n", drops, gaps);
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*********************************************************************
+ * FileName:        tracedump.c
+ * Processor:       Host (gcc)
+ *
+ * Decodes trace snapshots (Trace Module.h) captured off the serial
+ * port into a timeline and per id histograms.
+ *
+ *   gcc -Wall -I MechatronicsProjectOfDoom.X -o tracedump tools/tracedump/tracedump.c
+ *   stty -F /dev/ttyUSB0 38400 raw -echo; cat /dev/ttyUSB0 > trace.bin
+ *   ./tracedump [-t] [trace.bin]         (stdin without a file)
+ *
+ * For every id it reports
+ *   span    - begin to end, how long the code between the points took
+ *   period  - begin to the next begin, how often it runs and its jitter
+ * as min/mean/max and a histogram in powers of 2 microseconds.  Only
+ * pairs inside one snapshot count.  Times are Timer1 counts (1 us) that
+ * wrap every 65.536 ms, each point is taken as up to 32 ms after the
+ * one before it, or a little before it (a point that was interrupted by
+ * a high_isr one can land in the buffer ahead of it).  -t prints every
+ * point, snapshot by snapshot, with the span on each end.
+ ********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Trace Module.h"
+
+#define IDS     128
+#define BUCKETS 17              // <1, <2, <4 ... <65536 us
+
+typedef struct {
+    unsigned long count, min, max;
+    double total;
+    unsigned long histogram[BUCKETS];
+} Stat_t;
+
+static Stat_t span[IDS], period[IDS];
+static long lastBegin[IDS], open[IDS];
+
+static const char *Name(unsigned char id) {
+    static char text[16];
+
+    switch (id & ~TR_END) {
+        case TR_HIGH: return "high_isr";
+        case TR_LOW: return "low_isr";
+        case TR_ADC: return "adc";
+        case TR_LCD_PUT: return "lcd_put";
+    }
+    if ((id & ~TR_END) >= TR_TASK && (id & ~TR_END) < TR_TASK + 16)
+        sprintf(text, "task%d", (id & ~TR_END) - TR_TASK);
+    else
+        sprintf(text, "id 0x%02x", id & ~TR_END);
+    return text;
+}
+
+static void Add(Stat_t *s, unsigned long us) {
+    int b = 0;
+
+    if (!s->count || us < s->min)
+        s->min = us;
+    if (us > s->max)
+        s->max = us;
+    s->count++;
+    s->total += us;
+    while (b < BUCKETS - 1 && us >= (1UL << b))
+        b++;
+    s->histogram[b]++;
+}
+
+static void Print(const char *what, Stat_t *s) {
+    unsigned long most = 0;
+    int b, first = -1, last = 0, bar;
+
+    printf("  %-7s %7lu  min %6lu  mean %9.1f  max %6lu us\n", what, s->count, s->min,
+            s->total / s->count, s->max);
+    for (b = 0; b < BUCKETS; b++) {
+        if (s->histogram[b]) {
+            if (first < 0)
+                first = b;
+            last = b;
+        }
+        if (s->histogram[b] > most)
+            most = s->histogram[b];
+    }
+    for (b = first; b <= last; b++) {
+        printf("    < %5lu us %7lu ", 1UL << b, s->histogram[b]);
+        for (bar = (int) (s->histogram[b] * 40 / most); bar > 0; bar--)
+            putchar('#');
+        putchar('\n');
+    }
+}
+
+// One snapshot, times unwrapped from the first point
+static void Snapshot(unsigned char seq, const unsigned char *p, int n, int timeline) {
+    long t[256], d;
+    unsigned char id;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        t[i] = p[3 * i + 1] | p[3 * i + 2] << 8;
+        if (i) {
+            d = (t[i] - t[i - 1]) & 0xFFFF;
+            t[i] = t[i - 1] + (d >= 32768 ? d - 65536 : d);
+        }
+    }
+    for (i = 0; i < IDS; i++)
+        lastBegin[i] = open[i] = -1;
+    if (timeline)
+        printf("snapshot %u, %d points, %ld us\n", seq, n, n ? t[n - 1] - t[0] : 0);
+    for (i = 0; i < n; i++) {
+        id = p[3 * i];
+        if (id & TR_END) {
+            id &= ~TR_END;
+            if (open[id] >= 0) {
+                Add(&span[id], t[i] - open[id]);
+                if (timeline)
+                    printf("  %8ld  %-8s end   %6ld us\n", t[i] - t[0], Name(id), t[i] - open[id]);
+                open[id] = -1;
+            } else if (timeline)
+                printf("  %8ld  %-8s end\n", t[i] - t[0], Name(id));
+        } else {
+            if (lastBegin[id] >= 0)
+                Add(&period[id], t[i] - lastBegin[id]);
+            lastBegin[id] = open[id] = t[i];
+            if (timeline)
+                printf("  %8ld  %-8s begin\n", t[i] - t[0], Name(id));
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    static unsigned char buf[4 + 3 * 255 + 1];
+    int timeline = 0, c, n, i, id;
+    long snapshots = 0, bad = 0, missed = 0, last = -1;
+    unsigned char sum;
+    FILE *f = stdin;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t"))
+            timeline = 1;
+        else if ((f = fopen(argv[i], "rb")) == NULL) {
+            perror(argv[i]);
+            return 2;
+        }
+    }
+
+    // Hunt for the sync bytes, then read the rest of the snapshot.  A bad
+    // sum throws the snapshot away and hunts again from after it.
+    while ((c = getc(f)) != EOF) {
+        if (c != TRACE_SYNC1)
+            continue;
+        while ((c = getc(f)) == TRACE_SYNC1);
+        if (c != TRACE_SYNC2)
+            continue;
+        if (fread(buf, 1, 2, f) != 2)
+            break;
+        n = buf[1];
+        if (fread(buf + 2, 1, 3 * n + 1, f) != (size_t) (3 * n + 1))
+            break;
+        for (sum = 0, i = 0; i < 3 * n + 2; i++)
+            sum += buf[i];
+        if (sum != buf[3 * n + 2]) {
+            bad++;
+            continue;
+        }
+        if (last >= 0)
+            missed += (unsigned char) (buf[0] - last - 1);
+        last = buf[0];
+        snapshots++;
+        Snapshot(buf[0], buf + 2, n, timeline);
+    }
+
+    printf("\n%ld snapshots, %ld bad sums, %ld missed\n", snapshots, bad, missed);
+    for (id = 0; id < IDS; id++) {
+        if (!span[id].count && !period[id].count)
+            continue;
+        printf("\n%s\n", Name(id));
+        if (span[id].count)
+            Print("span", &span[id]);
+        if (period[id].count)
+            Print("period", &period[id]);
+    }
+    return 0;
+}